@@ -0,0 +1,98 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <sys/mman.h>
+
+//------------------------------------------------------------------------------------------------------------------------//
+//Arena
+// One contiguous region reserved up front for a whole simulation run. Engines allocate their timeline, queues and
+// bookkeeping from it with a bump pointer; reset() hands everything back in O(1) before the next algorithm.
+// Requests that do not fit fall back to the heap so an undersized estimate is slow, never wrong.
+class arena {
+public:
+    explicit arena(std::size_t capacity = 0, bool huge_pages = false) : huge_pages(huge_pages) {
+        reserve(capacity);
+    }
+    ~arena() { release(); }
+
+    arena(const arena&) = delete;
+    arena& operator=(const arena&) = delete;
+
+    // Make sure at least `bytes` are available; only call between runs since it may remap the region
+    void reserve(std::size_t bytes) {
+        if (bytes <= capacity) return;
+        release();
+        // MAP_NORESERVE keeps an over-estimate cheap: only touched pages are ever committed
+        void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (p == MAP_FAILED) return;
+#ifdef MADV_HUGEPAGE
+        if (huge_pages) madvise(p, bytes, MADV_HUGEPAGE);
+#endif
+        base = static_cast<char*>(p);
+        capacity = bytes;
+    }
+
+    void* allocate(std::size_t bytes, std::size_t alignment) {
+        std::size_t start = (used + alignment - 1) & ~(alignment - 1);
+        if (base && start + bytes <= capacity) {
+            used = start + bytes;
+            return base + start;
+        }
+        ++overflow_count;
+        return ::operator new(bytes);
+    }
+
+    void deallocate(void* p) {
+        if (!owns(p)) ::operator delete(p);
+    }
+
+    bool owns(const void* p) const {
+        const char* c = static_cast<const char*>(p);
+        return base && c >= base && c < base + capacity;
+    }
+
+    void reset() { used = 0; }
+
+    std::size_t bytes_used() const { return used; }
+    std::size_t bytes_reserved() const { return capacity; }
+    std::size_t overflows() const { return overflow_count; }
+
+private:
+    void release() {
+        if (base) munmap(base, capacity);
+        base = nullptr;
+        capacity = 0;
+        used = 0;
+    }
+
+    char* base = nullptr;
+    std::size_t capacity = 0;
+    std::size_t used = 0;
+    std::size_t overflow_count = 0;
+    bool huge_pages;
+};
+
+// Standard allocator adaptor so std containers can live inside an arena
+template <class T>
+struct arena_allocator {
+    using value_type = T;
+
+    arena* mem;
+
+    explicit arena_allocator(arena& mem) : mem(&mem) {}
+    template <class U>
+    arena_allocator(const arena_allocator<U>& other) : mem(other.mem) {}
+
+    T* allocate(std::size_t n) { return static_cast<T*>(mem->allocate(n * sizeof(T), alignof(T))); }
+    void deallocate(T* p, std::size_t) { mem->deallocate(p); }
+
+    template <class U>
+    bool operator==(const arena_allocator<U>& other) const { return mem == other.mem; }
+    template <class U>
+    bool operator!=(const arena_allocator<U>& other) const { return mem != other.mem; }
+};
+
+#endif
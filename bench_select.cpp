@@ -0,0 +1,73 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "select_kernels.h"
+
+// Times the SRT and HRRN selection kernels on a large ready set.
+// usage: bench_select [processes] [decisions]
+int main(int argc, char* argv[]) {
+    int n = argc > 1 ? std::atoi(argv[1]) : 100000;
+    int decisions = argc > 2 ? std::atoi(argv[2]) : 2000;
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> serviceDist(1, 1000);
+    std::uniform_int_distribution<int> arrivalDist(0, decisions);
+    std::vector<int> arrival(n), remaining(n);
+    for (int i = 0; i < n; ++i) {
+        arrival[i] = arrivalDist(rng);
+        remaining[i] = serviceDist(rng);
+    }
+
+    auto run = [&](const char* name, int (*kernel)(const int*, const int*, int, int)) {
+        std::vector<int> rem = remaining;
+        long long checksum = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int now = 0; now < decisions; ++now) {
+            int id = kernel(rem.data(), arrival.data(), n, now);
+            if (id >= 0) {
+                rem[id]--;
+                checksum += id;
+            }
+        }
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::printf("%-7s %9.2f ms  %8.1f ns/decision  checksum %lld\n", name, ms, ms * 1e6 / decisions, checksum);
+    };
+
+    std::printf("SRT selection, %d processes, %d decisions\n", n, decisions);
+    run("scalar", srt_select_scalar);
+    if (kernels_use_avx2()) {
+        run("avx2", srt_select_avx2);
+    } else {
+        std::printf("avx2    not available on this CPU\n");
+    }
+
+    // HRRN: arrivals laid out in arrival order, every pick completes one candidate
+    std::vector<int> sortedArrival = arrival;
+    std::sort(sortedArrival.begin(), sortedArrival.end());
+    auto runHrrn = [&](const char* name, int (*kernel)(const int*, const int*, const int*, int, int)) {
+        std::vector<int> done(n, 0);
+        long long checksum = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int now = 0; now < decisions; ++now) {
+            int pos = kernel(sortedArrival.data(), remaining.data(), done.data(), n, now + decisions);
+            if (pos >= 0) {
+                done[pos] = 1;
+                checksum += pos;
+            }
+        }
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::printf("%-7s %9.2f ms  %8.1f ns/decision  checksum %lld\n", name, ms, ms * 1e6 / decisions, checksum);
+    };
+
+    std::printf("HRRN selection, %d processes, %d decisions\n", n, decisions);
+    runHrrn("scalar", hrrn_select_scalar);
+    if (kernels_use_avx2()) {
+        runHrrn("avx2", hrrn_select_avx2);
+    } else {
+        std::printf("avx2    not available on this CPU\n");
+    }
+    return 0;
+}
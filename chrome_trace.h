@@ -0,0 +1,170 @@
+#ifndef CHROME_TRACE_H
+#define CHROME_TRACE_H
+
+#include <functional>
+#include <ostream>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+#include "scheduler.h"
+
+//------------------------------------------------------------------------------------------------------------------------//
+//Chrome trace export
+// Schedules written as Chrome Trace Event JSON, which chrome://tracing and Perfetto open directly. Every algorithm is
+// a trace process and every simulated process a thread of it. Each slice becomes one complete ("X") event, and a
+// counter track follows the length of the ready queue. One tick is shown as one microsecond. Events are written as
+// the engine yields them, so memory depends on the process count and not on the length of the schedule.
+
+// The event array of one trace file; events are separated by commas as they are added
+class chrome_trace_writer {
+public:
+    explicit chrome_trace_writer(std::ostream& out) : out(out) { out << "[\n"; }
+
+    chrome_trace_writer(const chrome_trace_writer&) = delete;
+    chrome_trace_writer& operator=(const chrome_trace_writer&) = delete;
+
+    // Starts a new event and returns the stream to write its object to
+    std::ostream& event() {
+        if (events++) out << ",\n";
+        return out;
+    }
+
+    void finish() { out << "\n]\n"; }
+
+    long long size() const { return events; }
+
+    // A JSON string literal
+    static std::string quoted(const std::string& text) {
+        std::string result = "\"";
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                result += '\\';
+                result += c;
+            } else if ((unsigned char)c < 0x20) {
+                const char* hex = "0123456789abcdef";
+                result += "\\u00";
+                result += hex[(c >> 4) & 0xf];
+                result += hex[c & 0xf];
+            } else {
+                result += c;
+            }
+        }
+        return result + "\"";
+    }
+
+private:
+    std::ostream& out;
+    long long events = 0;
+};
+
+// Sink writing one algorithm's schedule as trace process `pid`. The ready queue is reconstructed from the workload:
+// a process is ready from its arrival, and from the end of each I/O wait, until its current CPU burst has been
+// emitted in full, except while it is the one running. Aging reads the service column as a priority, so under it
+// nothing ever finishes.
+struct chrome_trace_output {
+    chrome_trace_writer& writer;
+    const workload& w;
+    int pid;
+    bool completes;
+    int now = 0;
+
+    chrome_trace_output(chrome_trace_writer& writer, const workload& w, int pid, const std::string& title, bool completes)
+        : writer(writer), w(w), pid(pid), completes(completes), executed(w.size(), 0), next_burst(w.size(), 0) {
+        writer.event() << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid
+                       << ",\"args\":{\"name\":" << chrome_trace_writer::quoted(title) << "}}";
+        for (int id = 0; id < w.size(); ++id) {
+            writer.event() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << id + 1
+                           << ",\"args\":{\"name\":" << chrome_trace_writer::quoted(nameOf(id)) << "}}";
+        }
+        publish(0, 0);
+    }
+
+    void emit(int id, int count) {
+        if (count <= 0) return;
+        int end = now + count;
+
+        // Arrivals and I/O completions during the slice change the queue behind the running process
+        admit(now);
+        running = id;
+        publish(now, readyLength());
+        while (nextEvent() < end) {
+            int at = nextEvent();
+            admit(at);
+            publish(at, readyLength());
+        }
+
+        if (id != IDLE) {
+            writer.event() << "{\"name\":" << chrome_trace_writer::quoted(nameOf(id)) << ",\"ph\":\"X\",\"pid\":" << pid
+                           << ",\"tid\":" << id + 1 << ",\"ts\":" << now << ",\"dur\":" << count << "}";
+            executed[id] += count;
+            if (completes && executed[id] >= burstLength(id)) {
+                finishBurst(id, end);
+            }
+        }
+        now = end;
+        running = IDLE;
+    }
+
+    // Writes the queue length at the end of the schedule
+    void close() {
+        admit(now);
+        publish(now, readyLength());
+    }
+
+private:
+    std::vector<int> executed;   // Ticks run in the current CPU burst
+    std::vector<int> next_burst; // Position in the burst list of the current CPU burst
+    std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>, std::greater<>> wakeups; // (time, id)
+    int next_arrival = 0;        // Position in by_arrival of the next process to arrive
+    int waiting = 0;             // Processes in a CPU burst, running or not
+    int running = IDLE;
+    int published = -1;
+
+    // The C API has no names
+    std::string nameOf(int id) const { return id < (int)w.names.size() ? w.names[id] : "P" + std::to_string(id); }
+
+    bool hasBursts(int id) const { return w.burst_start[id] < w.burst_start[id + 1]; }
+
+    int burstLength(int id) const {
+        return hasBursts(id) ? w.bursts[w.burst_start[id] + next_burst[id]] : w.service[id];
+    }
+
+    int nextEvent() const {
+        int arrival = next_arrival < w.size() ? w.sorted_arrival[next_arrival] : INT_MAX;
+        return wakeups.empty() ? arrival : std::min(arrival, wakeups.top().first);
+    }
+
+    // Processes that arrive or come back from I/O by `time` join the queue. A zero-length burst is never dispatched, so
+    // its process stays out of the queue for good, as it does in the engines.
+    void admit(int time) {
+        while (next_arrival < w.size() && w.sorted_arrival[next_arrival] <= time) {
+            int id = w.by_arrival[next_arrival++];
+            if (!completes || burstLength(id) > 0) waiting++;
+        }
+        while (!wakeups.empty() && wakeups.top().first <= time) {
+            if (burstLength(wakeups.top().second) > 0) waiting++;
+            wakeups.pop();
+        }
+    }
+
+    void finishBurst(int id, int end) {
+        waiting--;
+        executed[id] = 0;
+        if (hasBursts(id) && w.burst_start[id] + next_burst[id] + 1 < w.burst_start[id + 1]) {
+            wakeups.push({end + w.bursts[w.burst_start[id] + next_burst[id] + 1], id});
+            next_burst[id] += 2;
+        }
+    }
+
+    int readyLength() const { return waiting - (running != IDLE ? 1 : 0); }
+
+    void publish(int time, int length) {
+        if (length == published) return;
+        published = length;
+        writer.event() << "{\"name\":\"Ready queue\",\"ph\":\"C\",\"pid\":" << pid << ",\"ts\":" << time
+                       << ",\"args\":{\"length\":" << length << "}}";
+    }
+};
+
+#endif
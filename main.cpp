@@ -3,141 +3,415 @@
 #include <string>
 #include <sstream>
 #include <algorithm>
+#include <numeric>
 #include <queue>
 #include <iomanip>
 #include <stdio.h>
 #include <math.h>
-
-struct process {
-    std::string name;
-    int arrival_time;
-    int initial_priority;
-    int current_priority;
-    int insert_time=0;
-    int service_time;
-    int remaining_service_time;
-    int finish_time = 0;
-    int turnaround_time = 0;
-    float norm_turnaround_time = 0.0;
-    bool in_queue = false;
-};
-
-struct algorithm {
-    int algorithm_id;
-    int quantum=-1;
-};
+#include <cstring>
+#include <cctype>
+#include <cstdlib>
+#include <climits>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <csignal>
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include "scheduler.h"
+#include "spsc_ring.h"
+#include "work_stealing_pool.h"
+#include "result_cache.h"
+#include "chrome_trace.h"
+#include "schedule_log.h"
 
 //------------------------------------------------------------------------------------------------------------------------//
-//utilities 
+//utilities
+
+// Parses one "ID", "ID-quantum" or "ID-quantum-seed" algorithm token. The multi-level queue lists the policy of
+// each class after a colon, most urgent first, each optionally followed by "*weight" to share the CPU by weight
+// instead of strict priority: "13:2-2/3/1" or "13:2-2*4/3*2/1*1".
+algorithm parseAlgorithm(const std::string& token) {
+    algorithm algo;
+    size_t colonPos = token.find(':');
+    if (colonPos != std::string::npos) {
+        algo = parseAlgorithm(token.substr(0, colonPos));
+        std::stringstream classStream(token.substr(colonPos + 1));
+        std::string policy;
+        while (std::getline(classStream, policy, '/')) {
+            size_t starPos = policy.find('*');
+            algo.classes.push_back(parseAlgorithm(policy.substr(0, starPos)));
+            if (starPos != std::string::npos) algo.class_weights.push_back(std::stoi(policy.substr(starPos + 1)));
+        }
+        return algo;
+    }
+    size_t hyphenPos = token.find('-');
+    algo.algorithm_id = std::stoi(token.substr(0, hyphenPos));
+    if (hyphenPos != std::string::npos) {
+        algo.quantum = std::stoi(token.substr(hyphenPos + 1));
+        size_t seedPos = token.find('-', hyphenPos + 1);
+        if (seedPos != std::string::npos) algo.seed = std::stoul(token.substr(seedPos + 1));
+    }
+    return algo;
+}
 
-void parseInput(
+void parseHeader(
+    std::istream& in,
     std::string& operation,
     std::vector<algorithm>& algorithms,
     int& lastInstant,
-    std::vector<process>& processes,
     int& numProcesses
 )
 {
-    std::cin >> operation;
+    in >> operation;
     std::string algorithmChunk;
-    std::cin >> algorithmChunk;
+    in >> algorithmChunk;
     std::stringstream algoStream(algorithmChunk);
     std::string token;
 
     while (std::getline(algoStream, token, ',')) {
-        size_t hyphenPos = token.find('-');
-        int algorithmId = std::stoi(token.substr(0, hyphenPos));
-        int quantum = (hyphenPos != std::string::npos) ? std::stoi(token.substr(hyphenPos + 1)) : -1;
-        algorithm algo;
-        algo.algorithm_id = algorithmId;
-        algo.quantum = quantum;
-        algorithms.push_back(algo);
+        algorithms.push_back(parseAlgorithm(token));
     }
 
 
-    std::cin >> lastInstant;
-    std::cin >> numProcesses;
-    std::cin.ignore();
-    std::string processLine;
-    for (int i = 0; i < numProcesses; ++i) {
-        std::getline(std::cin, processLine);
-        if (processLine.empty()) {
-            std::cerr << "Error: Missing process details on line " << (i + 1) << "\n";
-            continue;
+    in >> lastInstant;
+    in >> numProcesses;
+    in.ignore();
+}
+
+// A group path is one or more "name" or "name:weight" parts separated by '/', with positive weights
+bool validGroupPath(const std::string& path) {
+    std::stringstream parts(path);
+    std::string part;
+    bool any = false;
+    while (std::getline(parts, part, '/')) {
+        size_t colon = part.find(':');
+        if (part.empty() || colon == 0) return false;
+        if (colon != std::string::npos) {
+            std::string weight = part.substr(colon + 1);
+            if (weight.empty() || !std::all_of(weight.begin(), weight.end(), ::isdigit) || std::stoi(weight) <= 0) {
+                return false;
+            }
         }
+        any = true;
+    }
+    return any && path.back() != '/';
+}
+
+// Parses one "name,arrival,service" line; complains on stderr and returns false when the line is unusable.
+// Optional fields may follow: more bursts for a process that does I/O ("name,arrival,cpu,io,cpu,...,cpu") and
+// key=value attributes such as tickets=N, deadline=T, class=K or group=path.
+bool parseProcessLine(const std::string& processLine, int lineNumber, process& proc) {
+    if (processLine.empty()) {
+        std::cerr << "Error: Missing process details on line " << lineNumber << "\n";
+        return false;
+    }
 
-        size_t pos1 = processLine.find(',');
-        size_t pos2 = processLine.find(',', pos1 + 1);
+    size_t pos1 = processLine.find(',');
+    size_t pos2 = processLine.find(',', pos1 + 1);
 
-        if (pos1 == std::string::npos || pos2 == std::string::npos) {
-            std::cerr << "Error: Invalid format for process line: " << processLine << "\n";
-            continue;
+    if (pos1 == std::string::npos || pos2 == std::string::npos) {
+        std::cerr << "Error: Invalid format for process line: " << processLine << "\n";
+        return false;
+    }
+
+    proc.name = processLine.substr(0, pos1);
+    proc.arrival_time = std::stoi(processLine.substr(pos1 + 1, pos2 - pos1 - 1));
+    proc.service_time = std::stoi(processLine.substr(pos2 + 1));
+    proc.bursts.clear();
+    proc.tickets = 1;
+    proc.deadline = NO_DEADLINE;
+    proc.class_id = 0;
+    proc.group.clear();
+    if (processLine.find(',', pos2 + 1) == std::string::npos) return true;
+
+    for (size_t pos = pos2; pos != std::string::npos; pos = processLine.find(',', pos + 1)) {
+        const char* field = processLine.c_str() + pos + 1;
+        if (std::strncmp(field, "tickets=", 8) == 0) {
+            proc.tickets = std::atoi(field + 8);
+            if (proc.tickets <= 0) {
+                std::cerr << "Error: Invalid ticket count on line " << lineNumber << ": " << processLine << "\n";
+                return false;
+            }
+        } else if (std::strncmp(field, "class=", 6) == 0) {
+            proc.class_id = std::atoi(field + 6);
+            if (!std::isdigit(static_cast<unsigned char>(field[6])) || proc.class_id >= MAX_CLASSES) {
+                std::cerr << "Error: Invalid class on line " << lineNumber << ": " << processLine << "\n";
+                return false;
+            }
+        } else if (std::strncmp(field, "group=", 6) == 0) {
+            const char* end = std::strchr(field, ',');
+            proc.group.assign(field + 6, end ? end : field + std::strlen(field));
+            if (!validGroupPath(proc.group)) {
+                std::cerr << "Error: Invalid group on line " << lineNumber << ": " << processLine << "\n";
+                return false;
+            }
+        } else if (std::strncmp(field, "deadline=", 9) == 0) {
+            if (!std::isdigit(static_cast<unsigned char>(field[9]))) {
+                std::cerr << "Error: Invalid deadline on line " << lineNumber << ": " << processLine << "\n";
+                return false;
+            }
+            proc.deadline = std::atoi(field + 9);
+        } else if (std::isdigit(static_cast<unsigned char>(*field))) {
+            proc.bursts.push_back(std::atoi(field));
+        } else {
+            std::cerr << "Error: Unknown field on line " << lineNumber << ": " << processLine << "\n";
+            return false;
         }
+    }
+    if (proc.bursts.size() <= 1) {
+        proc.bursts.clear();
+        return true;
+    }
 
-        std::string processName = processLine.substr(0, pos1);
-        int arrivalTime = std::stoi(processLine.substr(pos1 + 1, pos2 - pos1 - 1));
-        int serviceTime = std::stoi(processLine.substr(pos2 + 1));
+    // Burst list: CPU times at even positions, I/O times between them
+    if (proc.bursts.size() % 2 == 0) {
+        std::cerr << "Error: Burst list must end with a CPU burst on line " << lineNumber << ": " << processLine << "\n";
+        return false;
+    }
+    proc.service_time = 0;
+    for (size_t b = 0; b < proc.bursts.size(); b += 2) {
+        if (proc.bursts[b] <= 0) {
+            std::cerr << "Error: Invalid burst length on line " << lineNumber << ": " << processLine << "\n";
+            return false;
+        }
+        proc.service_time += proc.bursts[b];
+    }
+    return true;
+}
 
+void parseInput(
+    std::istream& in,
+    std::string& operation,
+    std::vector<algorithm>& algorithms,
+    int& lastInstant,
+    std::vector<process>& processes,
+    int& numProcesses
+)
+{
+    parseHeader(in, operation, algorithms, lastInstant, numProcesses);
+    std::string processLine;
+    for (int i = 0; i < numProcesses; ++i) {
+        std::getline(in, processLine);
         process proc;
-        proc.name = processName;
-        proc.arrival_time = arrivalTime;
-        proc.service_time = serviceTime;
-        proc.remaining_service_time = serviceTime;
-        proc.initial_priority = serviceTime;
-        proc.current_priority = serviceTime;
-        processes.push_back(proc);
+        if (parseProcessLine(processLine, i + 1, proc)) {
+            processes.push_back(proc);
+        }
     }
 }
 
-void updateFinishTimes(std::vector<process>& processes, const std::vector<std::string>& output) {
-    for (auto& p : processes) {
-        auto it = std::find(output.rbegin(), output.rend(), p.name);
-        if (it != output.rend()) {
-            p.finish_time = std::distance(output.begin(), it.base()) - 1;
+
+//------------------------------------------------------------------------------------------------------------------------//
+//Trace rendering
+// Rows are independent once each process's run intervals are known, so they are rendered straight into byte buffers,
+// a block of consecutive rows per thread, and written out in row order. Big traces go out in batches of about
+// traceBatchBytes, so memory stays bounded however large the trace is.
+
+const size_t traceBatchBytes = 64 << 20;
+const size_t traceBytesPerThread = 1 << 20; // Smaller blocks are not worth a thread
+
+// Writes the buffers to out in order; for std::cout they go straight to the descriptor with vectored writes
+void writeBuffers(std::ostream& out, const std::vector<std::string>& buffers) {
+    if (&out != &std::cout) {
+        for (const auto& buffer : buffers) {
+            out.write(buffer.data(), buffer.size());
+        }
+        return;
+    }
+    out.flush();
+    std::vector<iovec> iov;
+    for (const auto& buffer : buffers) {
+        if (!buffer.empty()) iov.push_back({const_cast<char*>(buffer.data()), buffer.size()});
+    }
+    size_t first = 0;
+    while (first < iov.size()) {
+        ssize_t written = writev(STDOUT_FILENO, &iov[first], std::min<size_t>(iov.size() - first, IOV_MAX));
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            out.setstate(std::ios::badbit);
+            return;
+        }
+        // Step past what was written, which may end partway through a buffer
+        while (first < iov.size() && (size_t)written >= iov[first].iov_len) {
+            written -= iov[first].iov_len;
+            first++;
+        }
+        if (written > 0) {
+            iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + written;
+            iov[first].iov_len -= written;
         }
     }
 }
 
+// Spans [start, end) each process spends blocked on I/O
+using io_waits = std::vector<std::vector<std::pair<int, int>>>;
 
-void outputTrace( std::vector<process>& processes,  std::vector<std::string>& output,  std::string& algoName) {
-    std::cout << std::left;
-    std::cout << std::setw(6) << algoName;
+// firstTick numbers the header when the timeline is a window starting later than tick 0. Time blocked on I/O is
+// drawn as ':'; it is worked out from the bursts unless the caller already knows it.
+void outputTrace(std::ostream& out, const workload& w, std::vector<process_stats>& stats, timeline& output, std::string& algoName,
+                 int firstTick = 0, const io_waits* blocked = nullptr) {
     int timelineLength = output.size();
+    int n = w.size();
+    bool aging = algoName == "Aging"; // Runs the processes as given, without their bursts
+    if (aging) {
+        for (int id = 0; id < n; ++id) {
+            stats[id].finish_time = timelineLength;
+        }
+    }
 
+    // The label column is 6 wide unless the algorithm's name needs more, as with CFS-20, and then every row widens
+    size_t labelWidth = std::max<size_t>(6, algoName.size() + 1);
+    out << std::left;
+    out << std::setw(labelWidth) << algoName;
+    std::string ticks(2 * (timelineLength + 1), ' ');
     for (int i = 0; i <= timelineLength; ++i) {
-        std::cout << i % 10 << " ";
+        ticks[2 * i] = '0' + (firstTick + i) % 10;
     }
-    std::cout << "\n------------------------------------------------\n";
+    out << ticks;
+    out << "\n------------------------------------------------\n";
 
-    // Print each process timeline
-    for ( auto& process : processes) {
-        if (algoName=="Aging"){
-            process.finish_time=timelineLength;
+    // Each process's runs on the CPU, grouped by process
+    std::vector<int> runOffset(n + 1, 0);
+    for (int i = 0; i < timelineLength; ++i) {
+        if (output[i] != IDLE && (i == 0 || output[i - 1] != output[i])) runOffset[output[i] + 1]++;
+    }
+    for (int id = 0; id < n; ++id) {
+        runOffset[id + 1] += runOffset[id];
+    }
+    std::vector<int> runStart(runOffset[n]);
+    std::vector<int> runEnd(runOffset[n]);
+    std::vector<int> runFill(runOffset.begin(), runOffset.end() - 1);
+    for (int i = 0; i < timelineLength; ++i) {
+        int id = output[i];
+        if (id == IDLE) continue;
+        if (i == 0 || output[i - 1] != id) {
+            runStart[runFill[id]] = i;
+            runEnd[runFill[id]++] = i;
         }
-        std::cout << std::setw(6) <<process.name << "|";
-        for (int i = 0; i < timelineLength; ++i) {
-            if (output[i] == process.name) {
-                std::cout << "*|";
-            } else if (i < process.finish_time && i >= process.arrival_time) {
-                std::cout << ".|";
-            } else {
-                std::cout << " |";
+        runEnd[runFill[id] - 1] = i + 1;
+    }
+
+    // Every row is the name padded to 6, a cell per tick and a trailing " \n"
+    std::string blankCells(2 * (size_t)timelineLength, '|');
+    for (int i = 0; i < timelineLength; ++i) {
+        blankCells[2 * i] = ' ';
+    }
+    auto rowBytes = [&](int id) {
+        return std::max(labelWidth, w.names[id].size()) + 1 + blankCells.size() + 2;
+    };
+    auto renderRow = [&](int id, char* p) {
+        const std::string& name = w.names[id];
+        size_t width = std::max(labelWidth, name.size());
+        std::memcpy(p, name.data(), name.size());
+        std::memset(p + name.size(), ' ', width - name.size());
+        p += width;
+        *p++ = '|';
+        std::memcpy(p, blankCells.data(), blankCells.size());
+        int waitFrom = std::max(0, w.arrival[id]);
+        int waitTo = std::min(timelineLength, stats[id].finish_time);
+        for (int i = waitFrom; i < waitTo; ++i) {
+            p[2 * i] = '.';
+        }
+        for (int r = runOffset[id]; r < runOffset[id + 1]; ++r) {
+            for (int i = runStart[r]; i < runEnd[r]; ++i) {
+                p[2 * i] = '*';
+            }
+        }
+        auto markBlocked = [&](int from, int to) {
+            for (int i = std::max(0, from); i < std::min(timelineLength, to); ++i) {
+                p[2 * i] = ':';
+            }
+        };
+        if (blocked) {
+            for (const auto& span : (*blocked)[id]) {
+                markBlocked(span.first, span.second);
+            }
+        } else if (!aging && w.burst_start[id] < w.burst_start[id + 1]) {
+            // A CPU burst ends once the process's runs have covered it, and the I/O after it starts there
+            int b = w.burst_start[id];
+            int left = w.bursts[b];
+            for (int r = runOffset[id]; r < runOffset[id + 1] && left > 0; ++r) {
+                for (int at = runStart[r]; at < runEnd[r] && left > 0;) {
+                    int run = std::min(left, runEnd[r] - at);
+                    at += run;
+                    left -= run;
+                    if (left == 0 && b + 1 < w.burst_start[id + 1]) {
+                        markBlocked(at, at + w.bursts[b + 1]);
+                        b += 2;
+                        left = w.bursts[b];
+                    }
+                }
+            }
+        }
+        p += blankCells.size();
+        p[0] = ' ';
+        p[1] = '\n';
+    };
+
+    // Renders rows [from, to) into one buffer
+    auto renderBlock = [&](int from, int to, std::string& buffer) {
+        size_t bytes = 0;
+        for (int id = from; id < to; ++id) {
+            bytes += rowBytes(id);
+        }
+        buffer.resize(bytes);
+        char* p = buffer.data();
+        for (int id = from; id < to; ++id) {
+            renderRow(id, p);
+            p += rowBytes(id);
+        }
+    };
+
+    int hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::string> buffers;
+    for (int batchStart = 0; batchStart < n;) {
+        // Take rows until the batch is full
+        int batchEnd = batchStart;
+        size_t batchBytes = 0;
+        while (batchEnd < n && (batchBytes == 0 || batchBytes + rowBytes(batchEnd) <= traceBatchBytes)) {
+            batchBytes += rowBytes(batchEnd++);
+        }
+
+        int rows = batchEnd - batchStart;
+        int threads = std::min<size_t>({(size_t)hardwareThreads, (size_t)rows, batchBytes / traceBytesPerThread + 1});
+        buffers.resize(threads);
+        if (threads == 1) {
+            renderBlock(batchStart, batchEnd, buffers[0]);
+        } else {
+            std::vector<std::thread> workers;
+            for (int t = 0; t < threads; ++t) {
+                int from = batchStart + (long long)rows * t / threads;
+                int to = batchStart + (long long)rows * (t + 1) / threads;
+                workers.emplace_back([&, from, to, t]() { renderBlock(from, to, buffers[t]); });
+            }
+            for (auto& worker : workers) {
+                worker.join();
             }
         }
-        std::cout << " ";
-        std::cout << "\n";
+        writeBuffers(out, buffers);
+        batchStart = batchEnd;
     }
-std::cout << "------------------------------------------------\n";
-std::cout << "\n";
+out << "------------------------------------------------\n";
+out << "\n";
 }
-void outputStats(const std::vector<process>& processes, const std::string& algoName) {
-    std::cout << algoName << "\n";
-    int n = processes.size();
+
+void outputStats(std::ostream& out, const workload& w, const std::vector<process_stats>& stats, const std::string& algoName) {
+    out << algoName << "\n";
+    int n = w.size();
     float meanTurnaround = 0.0, meanNormTurnaround = 0.0;
 
-    for (const auto& p : processes) {
-        meanTurnaround += p.turnaround_time;
-        meanNormTurnaround += p.norm_turnaround_time;
+    for (const auto& s : stats) {
+        meanTurnaround += s.turnaround_time;
+        meanNormTurnaround += s.norm_turnaround_time;
     }
     meanTurnaround /= n;
     meanNormTurnaround /= n;
@@ -155,659 +429,1637 @@ void outputStats(const std::vector<process>& processes, const std::string& algoN
         std::ostringstream oss;
         oss << std::fixed << std::setprecision(2) << value;
         std::string str = oss.str();
-        return std::string(width - str.length(), ' ') + str;
+        return std::string(std::max<int>(0, width - (int)str.length()), ' ') + str;
     };
 
     // Display table header
-    std::cout << "Process    |";
-    for (const auto& p : processes) {
-        std::cout << std::setw(3) << p.name << "  |";
+    out << "Process    |";
+    for (const auto& name : w.names) {
+        out << std::setw(3) << name << "  |";
     }
-    std::cout << "\n";
+    out << "\n";
 
     // Display arrival times
-    std::cout << "Arrival    |";
-    for (const auto& p : processes) {
-        std::cout << alignINT(p.arrival_time) << "  |";
+    out << "Arrival    |";
+    for (int arrival : w.arrival) {
+        out << alignINT(arrival) << "  |";
     }
-    std::cout << "\n";
+    out << "\n";
 
     // Display service times
-    std::cout << "Service    |";
-    for (const auto& p : processes) {
-        std::cout << alignINT(p.service_time) << "  |";
+    out << "Service    |";
+    for (int service : w.service) {
+        out << alignINT(service) << "  |";
     }
-    std::cout << " Mean|\n";
+    out << " Mean|\n";
 
     // Display finish times
-    std::cout << "Finish     |";
-    for (const auto& p : processes) {
-        std::cout << alignINT(p.finish_time) << "  |";
+    out << "Finish     |";
+    for (const auto& s : stats) {
+        out << alignINT(s.finish_time) << "  |";
     }
-    std::cout << "-----|\n";
+    out << "-----|\n";
 
     // Display turnaround times
-    std::cout << "Turnaround |";
-    for (const auto& p : processes) {
-        std::cout << alignINT(p.turnaround_time) << "  |";
+    out << "Turnaround |";
+    for (const auto& s : stats) {
+        out << alignINT(s.turnaround_time) << "  |";
     }
-    std::cout << alignFloat(meanTurnaround) << "|\n";
+    out << alignFloat(meanTurnaround) << "|\n";
 
     // Display normalized turnaround times
-    std::cout << "NormTurn   |";
-    for (const auto& p : processes) {
-        std::cout << " " << alignFloat(p.norm_turnaround_time, 4) << "|";
+    out << "NormTurn   |";
+    for (const auto& s : stats) {
+        out << " " << alignFloat(s.norm_turnaround_time, 4) << "|";
     }
-    std::cout << alignFloat(meanNormTurnaround) << "|\n";
-}
-
-
+    out << alignFloat(meanNormTurnaround) << "|\n";
 
-
-struct CompareServiceTime {
-    bool operator()(const process& a, const process& b) {
-        return a.service_time > b.service_time;
+    // Deadlines given in the input are checked whatever the algorithm; Aging's finish times are not real ones
+    if (w.has_deadlines() && algoName != "Aging") {
+        out << "Deadline   |";
+        for (int deadline : w.deadlines) {
+            out << (deadline == NO_DEADLINE ? "  -  |" : alignINT(deadline) + "  |");
+        }
+        out << "-----|\n";
+        out << "Lateness   |";
+        for (int id = 0; id < n; ++id) {
+            bool known = w.deadlines[id] != NO_DEADLINE && stats[id].finish_time > 0;
+            if (known) {
+                out << std::setw(3) << stats[id].finish_time - w.deadlines[id] << "  |";
+            } else {
+                out << "  -  |";
+            }
+        }
+        out << "-----|\n";
+        deadline_report report = deadlineReport(w, stats);
+        out << "Missed " << report.missed << " of " << report.with_deadline << " deadlines, lateness p50 "
+            << report.p50 << " p90 " << report.p90 << " p99 " << report.p99 << " max " << report.max
+            << ", utilization " << alignFloat(report.utilization, 0) << "\n";
     }
-};
 
-struct ComparePriority {
-    bool operator()(const process& a, const process& b) {
-        return a.current_priority > b.current_priority;
+    // Proportional-share schedulers also report the CPU share each process got against the one its tickets bought
+    if (algoName.rfind("LOT", 0) == 0 || algoName.rfind("STR", 0) == 0 || algoName.rfind("CFS", 0) == 0) {
+        std::vector<double> target = targetShares(w, stats);
+        out << "Share      |";
+        for (int id = 0; id < n; ++id) {
+            double share = stats[id].turnaround_time > 0 ? double(w.service[id]) / stats[id].turnaround_time : 0.0;
+            out << " " << alignFloat(share, 4) << "|";
+        }
+        out << "-----|\n";
+        out << "Target     |";
+        for (int id = 0; id < n; ++id) {
+            out << " " << alignFloat(target[id], 4) << "|";
+        }
+        out << "-----|\n";
     }
-};
+}
+
 
 void printProcess(std::vector<process>& processes) {
     for (int i = 0; i < processes.size(); i++) {
         printf("Process Name: %s\n", processes[i].name.c_str());
         printf("Arrival Time: %d\n", processes[i].arrival_time);
         printf("Service Time: %d\n", processes[i].service_time);
-        // printf("Remaining Service Time: %d\n", processes[i].remaining_service_time);
-        // printf("Finish Time: %d\n", processes[i].finish_time);
-        // printf("Turnaround Time: %d\n", processes[i].turnaround_time);
-        // printf("Normalized Turnaround Time: %f\n", processes[i].norm_turnaround_time);
     }
 }
 
-void calculateStatsFromOutput(const std::vector<std::string>& output, std::vector<process>& processes) {
-    for (auto& p : processes) {
-        // Find the first and last occurrences of the process in the output
-        auto first_it = std::find(output.begin(), output.end(), p.name);
-        auto last_it = std::find(output.rbegin(), output.rend(), p.name);
 
-        if (first_it != output.end()) {
-            int first_index = std::distance(output.begin(), first_it);
-            int last_index = std::distance(output.begin(), last_it.base()) - 1;
+std::string algorithmName(const algorithm& algo) {
+    std::string algoName;
 
-            // Calculate finish time, turnaround time, and normalized turnaround time
-            p.finish_time = last_index + 1;  // Finish time is the last occurrence + 1
-            p.turnaround_time = p.finish_time - p.arrival_time;
-            p.norm_turnaround_time =
-                static_cast<float>(p.turnaround_time) / p.service_time;
-        }
+    switch (algo.algorithm_id) {
+        case 1:
+            algoName = "FCFS";
+            break;
+        case 2:
+            algoName = "RR";
+            break;
+        case 3:
+            algoName = "SPN";
+            break;
+        case 4:
+            algoName = "SRT";
+            break;
+        case 5:
+            algoName = "HRRN";
+            break;
+        case 6:
+            algoName = "FB-1";
+            break;
+        case 7:
+            algoName = "FB-2i";
+            break;
+        case 8:
+            algoName = "Aging";
+            break;
+        case 9:
+            algoName = "LOT";
+            break;
+        case 10:
+            algoName = "STR";
+            break;
+        case 11:
+            algoName = "EDF";
+            break;
+        case 12:
+            algoName = "CFS";
+            break;
+        case 13:
+            algoName = algo.class_weights.empty() ? "MLQ" : "MLQ-w";
+            break;
+        case 14:
+            algoName = "HFS";
+            break;
+        default:
+            algoName = "Unknown";
+            break;
     }
+    if (algoName == "RR") {
+        algoName = algoName + "-" + std::to_string(algo.quantum);
+    } else if (algoName == "LOT" || algoName == "STR" || algoName == "HFS") {
+        algoName = algoName + "-" + std::to_string(std::max(1, algo.quantum));
+    } else if (algoName == "CFS") {
+        algoName = algoName + "-" + std::to_string(algo.quantum > 0 ? algo.quantum : CFS_DEFAULT_LATENCY);
+    }
+    return algoName;
 }
 
-
-
-//Algorithms
 //------------------------------------------------------------------------------------------------------------------------//
-//First Come First Serve
-std::vector<std::string> fcfs(std::vector<process>& processes, std::vector<std::string>& output) {
-    int n = processes.size();
-    std::sort(processes.begin(), processes.end(), [](const process& a, const process& b) {
-        return a.arrival_time < b.arrival_time;
-    });
-    int currentTime = 0;
-    for (int i = 0; i < n; ++i) {
-        if (currentTime < processes[i].arrival_time) {
-            // Add idle time if the CPU is idle
-            for (int idle = currentTime; idle < processes[i].arrival_time; ++idle) {
-                output.push_back("-");
-            }
-            currentTime = processes[i].arrival_time;
-        }
-        for (int j = 0; j < processes[i].service_time; ++j) {
-            output.push_back(processes[i].name); 
-        }
+//Streamed arrivals
+// Arrivals streamed from the parser thread. Each process is appended to the workload as it is handed out, so the
+// engine sees exactly the prefix of the workload that has arrived. Needs the input in arrival order.
+struct stream_arrivals {
+    spsc_ring<process>& ring;
+    workload& w;
+    int declared;
+    process lookahead;
+    bool has_lookahead = false;
+
+    stream_arrivals(spsc_ring<process>& ring, workload& w, int declared) : ring(ring), w(w), declared(declared) {}
+
+    int capacity() const { return declared; }
+
+    // Blocks until the next process is known or the parser is done
+    bool exhausted() {
+        if (!has_lookahead) has_lookahead = w.size() < declared && ring.pop(lookahead);
+        return !has_lookahead;
+    }
 
-        processes[i].finish_time = std::max(currentTime, processes[i].arrival_time) + processes[i].service_time;
+    int next_arrival() { return exhausted() ? INT_MAX : lookahead.arrival_time; }
 
-        processes[i].turnaround_time = processes[i].finish_time - processes[i].arrival_time;
-        processes[i].norm_turnaround_time =
-            static_cast<float>(processes[i].turnaround_time) / processes[i].service_time;
-        currentTime = processes[i].finish_time;
+    bool pop_arrived(int now, int& id) {
+        if (exhausted() || lookahead.arrival_time > now) return false;
+        return pop(id);
     }
-    return output;
-}
 
-//------------------------------------------------------------------------------------------------------------------------//
-//Round Robin
-std::vector<std::string> RR(std::vector<process>& processes, std::vector<std::string>& output, int quantum) {
-    int n = processes.size();
-    std::vector<process> backup_processes = processes;
-    std::queue<int> ready_queue; 
-    int currentTime = 0;
-    int j = 0; 
-    int old_index = 0;
-
-    std::sort(backup_processes.begin(), backup_processes.end(), [](const process& a, const process& b) {
-        return a.arrival_time < b.arrival_time;
-    });
-
-    while (true) {
-        while (j < n && backup_processes[j].arrival_time <= currentTime) {
-            ready_queue.push(j);
-            j++;
-        }
+    bool pop(int& id) {
+        if (exhausted()) return false;
+        id = appendProcess(w, lookahead);
+        has_lookahead = false;
+        return true;
+    }
 
-        if (ready_queue.empty()) {
-            if (j >= n)
-                break;
+    // Pulls in whatever the engine did not need, so the workload is complete for later runs
+    void drain() {
+        int id;
+        while (pop(id)) {
         }
+    }
+};
 
-        int processIndex = ready_queue.front();
-        ready_queue.pop();
+//------------------------------------------------------------------------------------------------------------------------//
+//Pipeline output
 
-        int timeSlice = std::min(quantum, backup_processes[processIndex].remaining_service_time);
+const int END_OF_RUN = -2; // slice.process marking the end of one algorithm's timeline
 
-        for (int i = 0; i < timeSlice; i++) {
-            output.push_back(backup_processes[processIndex].name);
-        }
+// Coalesces the schedule into slices and streams them to the renderer thread
+struct ring_output {
+    spsc_ring<slice>& ring;
+    slice pending{IDLE, 0, 0};
+    int now = 0;
 
-        currentTime += timeSlice;
-        backup_processes[processIndex].remaining_service_time -= timeSlice;
+    explicit ring_output(spsc_ring<slice>& ring) : ring(ring) {}
 
-        while (j < n && backup_processes[j].arrival_time <= currentTime) {
-            ready_queue.push(j);
-            j++;
+    void emit(int id, int count) {
+        if (count <= 0) return;
+        if (pending.length > 0 && pending.process == id) {
+            pending.length += count;
+        } else {
+            flush();
+            pending = {id, now, count};
         }
+        now += count;
+    }
 
-        if (backup_processes[processIndex].remaining_service_time != 0) {
-            ready_queue.push(processIndex);
-        }
+    void flush() {
+        if (pending.length > 0) ring.push(pending);
+        pending.length = 0;
     }
 
-    return output;
+    // Flushes the last slice and tells the renderer this run is complete
+    void finish() {
+        flush();
+        ring.push({END_OF_RUN, now, 0});
+    }
+};
+
+
+void printResult(std::ostream& out, const std::string& operation, const workload& w, std::vector<process_stats>& stats,
+                 timeline& output, std::string& algoName) {
+    if (operation == "trace") {
+        outputTrace(out, w, stats, output, algoName);
+    } else if (operation == "stats") {
+        outputStats(out, w, stats, algoName);
+    } else {
+        std::cerr << "Invalid operation. Use 'trace' or 'stats'.\n";
+    }
 }
 
+
 //------------------------------------------------------------------------------------------------------------------------//
-//Highest Response Ratio Next
-std::vector<std::string> HRRN(std::vector<process>& processes, std::vector<std::string>& output) {
-    int n = processes.size();
-    std::vector<bool> completed(n, false); // Track completed processes
-    int current_time = 0;
-
-    // Sort processes by arrival time
-    std::sort(processes.begin(), processes.end(), [](const process& a, const process& b) {
-        return a.arrival_time < b.arrival_time;
-    });
+//Split runs
+// A work-conserving engine has nothing left in its queues whenever the CPU goes idle, so the busy periods that follow
+// are independent schedules. The workload is cut at idle boundaries into chunks of about equal work, every chunk is
+// simulated by its own engine on the pool with arrivals shifted to start at 0, and the slices are written straight
+// into the caller's stats or timeline at the chunk's offset. Chunks end where the next one starts, so the idle time
+// between them, and the idle ticks SRT and FB spend waiting for lastInstant, come out exactly as in one run.
+
+// FCFS, RR, SPN, SRT, HRRN and the feedback engines; the rest carry state such as a random draw or a virtual clock
+// across idle time
+bool splitsAtIdle(const algorithm& algo, const workload& w) {
+    return algo.algorithm_id >= 1 && algo.algorithm_id <= 7 && !w.has_io();
+}
 
-    for (int completed_count = 0; completed_count < n; ++completed_count) {
-        float max_response_ratio = -1.0f;
-        int selected_process = -1;
+// SRT and the feedback engines run until total_time even with nothing left to do
+bool runsToTotalTime(const algorithm& algo) {
+    return algo.algorithm_id == 4 || algo.algorithm_id == 6 || algo.algorithm_id == 7;
+}
 
-        // Find the process with the highest response ratio
-        for (int i = 0; i < n; ++i) {
-            if (!completed[i] && processes[i].arrival_time <= current_time) {
-                int waiting_time = current_time - processes[i].arrival_time;
-                float response_ratio = (waiting_time + processes[i].service_time) / static_cast<float>(processes[i].service_time);
+// The processes of one chunk, under their own ids
+struct chunk_arrivals : workload_arrivals {
+    int slots;
+    chunk_arrivals(const workload& w, int slots) : workload_arrivals(w), slots(slots) {}
+    int capacity() const { return slots; }
+};
 
-                if (response_ratio > max_response_ratio) {
-                    max_response_ratio = response_ratio;
-                    selected_process = i;
-                }
-            }
-        }
+// Chunk sinks: ids maps the chunk's process ids back, and times are offset by the chunk's start
+struct chunk_finish_output {
+    static constexpr bool finishes_only = true;
+    std::vector<process_stats>& stats;
+    const std::vector<int>& ids;
+    int now;
+
+    void emit(int id, int count) {
+        if (count <= 0) return;
+        now += count;
+        if (id >= 0) stats[ids[id]].finish_time = now;
+    }
+};
 
-        // If no process is ready, advance time
-        if (selected_process == -1) {
-            output.push_back("-");
-            current_time++;
-            continue;
-        }
+struct chunk_timeline_output {
+    int* ticks;
+    const std::vector<int>& ids;
+    int now;
 
-        // Execute the selected process
-        process& current_process = processes[selected_process];
-        for (int j = 0; j < current_process.service_time; ++j) {
-            output.push_back(current_process.name);
+    void emit(int id, int count) {
+        if (count <= 0) return;
+        std::fill(ticks + now, ticks + now + count, id == IDLE ? IDLE : ids[id]);
+        now += count;
+    }
+};
+
+// Runs a splittable algorithm chunk by chunk on the pool. makeSink(ids, start) gives the sink for one chunk; the last
+// chunk runs until its engine stops, which for the feedback engines can be a little past total_time. Returns the
+// length of the schedule.
+template <class MakeSink>
+int runSplit(const algorithm& algo, const workload& w, int total_time, work_stealing_pool& pool, MakeSink makeSink) {
+    long long lastEnd;
+    std::vector<int> boundaries = idleBoundaries(w, lastEnd);
+    bool toTotalTime = runsToTotalTime(algo) && total_time != UNTIL_DRAINED;
+    long long length = toTotalTime ? std::max(0, total_time) : lastEnd; // No chunk starts at or after this
+
+    // Group busy periods into chunks of roughly equal work, a few per worker so stealing can even out the rest
+    long long totalWork = 0;
+    for (int service : w.sorted_service) {
+        totalWork += service;
+    }
+    long long chunkWork = std::max(1LL, totalWork / (pool.size() * 4));
+    std::vector<int> chunkFirst;
+    long long work = chunkWork;
+    for (size_t b = 0; b < boundaries.size(); ++b) {
+        int pos = boundaries[b];
+        if (w.sorted_arrival[pos] >= length && pos > 0) break; // Nothing from here on runs before the end
+        if (work >= chunkWork) {
+            chunkFirst.push_back(pos);
+            work = 0;
+        }
+        int next = b + 1 < boundaries.size() ? boundaries[b + 1] : w.size();
+        for (int p = pos; p < next; ++p) {
+            work += w.sorted_service[p];
         }
-        current_time += current_process.service_time;
+    }
+    int chunks = chunkFirst.size();
+
+    // FB caps a process's level at the process count, so every chunk has to report the full count
+    int slots = algo.algorithm_id == 6 || algo.algorithm_id == 7 ? w.size() : 0;
+    int scheduleEnd = 0;
+    std::vector<std::unique_ptr<arena>> arenas;
+    for (int i = 0; i < pool.size(); ++i) {
+        arenas.emplace_back(new arena());
+    }
+    for (int c = 0; c < chunks; ++c) {
+        pool.submit([&, c](int worker) {
+            int first = chunkFirst[c];
+            int last = c + 1 < chunks ? chunkFirst[c + 1] : w.size();
+            int start = c == 0 ? 0 : w.sorted_arrival[first];
+            bool lastChunk = c + 1 == chunks;
+            int limit = lastChunk ? INT_MAX - start : w.sorted_arrival[last] - start;
+
+            // Chunk ids keep the input order, so every tie breaks as it would in one run
+            std::vector<int> ids(w.by_arrival.begin() + first, w.by_arrival.begin() + last);
+            std::sort(ids.begin(), ids.end());
+            std::vector<int> arrival(ids.size()), service(ids.size());
+            for (size_t k = 0; k < ids.size(); ++k) {
+                arrival[k] = w.arrival[ids[k]] - start;
+                service[k] = w.service[ids[k]];
+            }
+            workload chunk;
+            buildWorkload(chunk, arrival.data(), service.data(), ids.size());
+
+            arena& mem = *arenas[worker];
+            chunk_arrivals source(chunk, std::max<int>(slots, ids.size()));
+            mem.reserve(arenaBytes(source.capacity(), lastChunk ? timelineBound(chunk, total_time) : limit));
+            {
+                auto sink = makeSink(ids, start);
+                slice_generator engine = schedule(algo, chunk, source, mem, toTotalTime ? total_time - start : total_time,
+                                                  finishesOnly<decltype(sink)>());
+                slice s;
+                int now = 0;
+                while (now < limit && engine.next(s)) {
+                    int count = std::min(s.length, limit - now);
+                    sink.emit(s.process, count);
+                    now += count;
+                }
+                if (lastChunk) {
+                    scheduleEnd = start + now;
+                } else {
+                    sink.emit(IDLE, limit - now);
+                }
+            }
+            mem.reset();
+        });
+    }
+    pool.wait();
+    return scheduleEnd;
+}
 
-        // Update process metrics
-        current_process.finish_time = current_time;
-        current_process.turnaround_time = current_process.finish_time - current_process.arrival_time;
-        current_process.norm_turnaround_time = static_cast<float>(current_process.turnaround_time) / current_process.service_time;
+// FCFS finish times follow finish = max(arrival, previous finish) + service in arrival order. The steps compose: a run
+// of processes takes an incoming finish x to sum + max(x, reach), where sum is its total service and reach the largest
+// arrival minus the service before it. The pool folds each block of the arrival-sorted arrays to that pair, a pass
+// over the few blocks gives each its incoming finish, and the pool sweeps the blocks again to write finish times.
+// Zero-service processes never show up in the schedule, so they keep a finish time of 0 as in a sequential run.
+// Returns the length of the schedule.
+int fcfsScan(const workload& w, std::vector<process_stats>& stats, work_stealing_pool& pool) {
+    const int minBlock = 1 << 15; // Smaller blocks cost more in hand-offs than they save
+    int n = w.size();
+    int blocks = std::max(1, std::min(pool.size() * 4, n / minBlock));
+    std::vector<long long> sum(blocks), reach(blocks), incoming(blocks + 1, 0);
+
+    // One block, starting from an incoming finish; the finish times are written when asked
+    auto sweep = [&](int b, bool write) {
+        int begin = (long long)n * b / blocks;
+        int end = (long long)n * (b + 1) / blocks;
+        long long total = 0;
+        long long latest = LLONG_MIN;
+        for (int pos = begin; pos < end; ++pos) {
+            latest = std::max(latest, (long long)w.sorted_arrival[pos] - total);
+            total += w.sorted_service[pos];
+            if (write) {
+                int finish = total + std::max(incoming[b], latest);
+                stats[w.by_arrival[pos]].finish_time = w.sorted_service[pos] > 0 ? finish : 0;
+            }
+        }
+        sum[b] = total;
+        reach[b] = latest;
+    };
 
-        // Mark the process as completed
-        completed[selected_process] = true;
+    for (int b = 0; b < blocks; ++b) {
+        pool.submit([&, b](int) { sweep(b, false); });
     }
-
-    return output;
+    pool.wait();
+    for (int b = 0; b < blocks; ++b) {
+        incoming[b + 1] = sum[b] + std::max(incoming[b], reach[b]);
+    }
+    for (int b = 0; b < blocks; ++b) {
+        pool.submit([&, b](int) { sweep(b, true); });
+    }
+    pool.wait();
+    return incoming[blocks];
 }
 
 //------------------------------------------------------------------------------------------------------------------------//
-//Aging
-
-std::vector<std::string> aging(std::vector<process>& processes, int total_time, int quantum, std::vector<std::string>& output) {
-    int current_time = 0;
-    std::vector<process*> ready_queue;
-
-    // Sort processes by arrival time
-    std::sort(processes.begin(), processes.end(), [](const process& a, const process& b) {
-        return a.arrival_time < b.arrival_time;
-    });
-    
-    while (current_time < total_time) {
-        // Add newly arrived processes to ready queue
-        for (auto& process : processes) {
-            if (process.arrival_time <= current_time && !process.in_queue) {
-                process.current_priority = process.initial_priority;
-                process.insert_time = current_time;
-                process.in_queue = true;
-                ready_queue.push_back(&process);
-            }
-        }
-        
-        if (ready_queue.empty()) {
-            output.push_back("-");
-            current_time++;
-            continue;
-        }
-        
-        // Find highest priority process with special handling for equal priorities
-        process* current_process = nullptr;
-        auto highest_priority_it = ready_queue.begin();
-        for (auto it = ready_queue.begin(); it != ready_queue.end(); ++it) {
-            if (!current_process || 
-                (*it)->current_priority > current_process->current_priority ||
-                ((*it)->current_priority == current_process->current_priority && 
-                 (*it)->insert_time < current_process->insert_time)) {
-                current_process = *it;
-                highest_priority_it = it;
-            }
-        }
-        
-        ready_queue.erase(highest_priority_it);
-        
-        // Execute process
-        bool completed_quantum = false;
-        int executed_time = 0;
-        while (executed_time < quantum && current_time < total_time) {
-            output.push_back(current_process->name);
-            current_time++;
-            executed_time++;
-            
-            // Check for new arrivals
-            for (auto& process : processes) {
-                if (process.arrival_time <= current_time && !process.in_queue) {
-                    process.current_priority = process.initial_priority;
-                    process.in_queue = true;
-                    process.insert_time = current_time;
-                    ready_queue.push_back(&process);
-                }
+//Batch run
+
+// Runs one algorithm over a built workload and writes its trace or stats. Returns the timeline length.
+// Everything the engine allocates comes from the arena, which is reset before returning. With a cache, a run
+// that was done before is printed from the stored result without running the engine. With a pool, algorithms that
+// split at idle boundaries run their busy periods in parallel.
+int runAlgorithm(std::ostream& out, const std::string& operation, const algorithm& algo, const workload& w,
+                 int lastInstant, arena& runArena, result_cache* cache = nullptr, work_stealing_pool* pool = nullptr) {
+    std::string algoName = algorithmName(algo);
+    std::vector<process_stats> stats;
+    bool split = pool && splitsAtIdle(algo, w);
+    bool caching = cache && cache->enabled();
+    std::string key = caching ? result_cache::key(w, algo, lastInstant) : std::string();
+    cached_result cached;
+
+    // Stats only need finish times, so non-preemptive engines finish in time proportional to the process count
+    if (operation == "stats") {
+        stats.assign(w.size(), process_stats());
+        int length;
+        if (caching && cache->load(key, w.size(), timelineBound(w, lastInstant), false, cached)) {
+            for (int id = 0; id < w.size(); ++id) {
+                stats[id].finish_time = cached.finish[id];
             }
-            
-            // Age waiting processes
-            for (auto* process : ready_queue) {
-                if (process != current_process) {
-                    process->current_priority++;
+            length = cached.ticks;
+        } else {
+            bool known = true;
+            if (split) {
+                if (algo.algorithm_id == 1) {
+                    length = fcfsScan(w, stats, *pool);
+                } else {
+                    length = runSplit(algo, w, lastInstant, *pool, [&stats](const std::vector<int>& ids, int start) {
+                        return chunk_finish_output{stats, ids, start};
+                    });
                 }
+            } else {
+                runArena.reserve(arenaBytes(algo, w, timelineBound(w, lastInstant)));
+                finish_output sink{stats};
+                known = run_workload(algo, w, sink, runArena, lastInstant);
+                if (!known) {
+                    out << "Invalid Algorithm\n";
+                }
+                runArena.reset();
+                length = sink.now;
             }
-            
-            completed_quantum = (executed_time == quantum);
-        }
-        
-        if (current_time < total_time) {
-            if (completed_quantum || !ready_queue.empty()) {
-                current_process->current_priority = current_process->initial_priority;
+            if (caching && known) {
+                cached.ticks = length;
+                for (const auto& s : stats) {
+                    cached.finish.push_back(s.finish_time);
+                }
+                cache->store(key, cached);
             }
-            ready_queue.push_back(current_process);
-            current_process->insert_time = current_time;
         }
+        completeStats(w, stats);
+        outputStats(out, w, stats, algoName);
+        return length;
     }
-    
-    return output;
-}
-//------------------------------------------------------------------------------------------------------------------------//
-//Shortest Process Next
-std::vector<std::string> SPN(std::vector<process>& processes, std::vector<std::string>& output) {
-    int current_time = 0;
-    std::vector<process> backup_processes = processes;
-    std::priority_queue<process, std::vector<process>, CompareServiceTime> ready_queue;
-
-    while (!processes.empty() || !ready_queue.empty()) {
-        // Add processes to the ready queue if they have arrived
-        for (auto it = processes.begin(); it != processes.end();) {
-            if (it->arrival_time <= current_time) {
-                // std::cout << it->name << " added to ready queue\n";
-                ready_queue.push(*it);
-                it = processes.erase(it);
+
+    int ticks = timelineBound(w, lastInstant);
+    bool hit = caching && cache->load(key, w.size(), ticks, true, cached);
+    runArena.reserve(arenaBytes(algo, w, hit ? cached.ticks : ticks));
+
+    int length;
+    {
+        timeline output{arena_allocator<int>(runArena)};
+        if (hit) {
+            output.reserve(cached.ticks);
+            for (const auto& run : cached.runs) {
+                output.insert(output.end(), run.second, run.first);
+            }
+            calculateStatsFromOutput(w, output, stats);
+        } else {
+            bool known = true;
+            if (split) {
+                // Chunks write their own stretch of the timeline, so it is sized before they start
+                output.resize(ticks);
+                int* start = output.data();
+                output.resize(runSplit(algo, w, lastInstant, *pool, [start](const std::vector<int>& ids, int offset) {
+                    return chunk_timeline_output{start, ids, offset};
+                }));
             } else {
-                ++it; // Move to the next process
+                output.reserve(ticks);
+
+                // Apply the algorithm
+                timeline_output sink{output};
+                known = run_workload(algo, w, sink, runArena, lastInstant);
+                if (!known) {
+                    out << "Invalid Algorithm\n";
+                }
+            }
+            calculateStatsFromOutput(w, output, stats);
+            if (caching && known) {
+                cached.ticks = output.size();
+                cached.has_timeline = true;
+                for (const auto& s : stats) {
+                    cached.finish.push_back(s.finish_time);
+                }
+                for (size_t i = 0; i < output.size();) {
+                    size_t end = i;
+                    while (end < output.size() && output[end] == output[i]) ++end;
+                    cached.runs.push_back({output[i], int(end - i)});
+                    i = end;
+                }
+                cache->store(key, cached);
             }
         }
+        printResult(out, operation, w, stats, output, algoName);
+        length = output.size();
+    }
+    runArena.reset();
+    return length;
+}
 
-        // If the ready queue is empty, CPU is idle
-        if (ready_queue.empty()) {
-            output.push_back("-");
-            current_time++;
-            continue;
-        }
+// Parses one complete input, runs every requested algorithm and writes the results. The arena only grows, so a
+// caller can keep one warm across inputs.
+void runBatch(std::istream& in, std::ostream& out, arena& runArena, result_cache* cache = nullptr,
+              work_stealing_pool* pool = nullptr) {
+    std::string operation;
+    std::vector<algorithm> algorithms;
+    int lastInstant;
+    int numProcesses;
+    std::vector<process> processes;
+    parseInput(in, operation, algorithms, lastInstant, processes, numProcesses);
 
-        // Process the shortest job
-        process current_process = ready_queue.top();
-        ready_queue.pop();
+    // Every engine reads the same preprocessed workload; per-run state lives in the arena
+    const workload w = buildWorkload(processes);
 
-        // std::cout << "Processing " << current_process.name << " from time " << current_time << "\n";
+    for (const auto& algo : algorithms) {
+        runAlgorithm(out, operation, algo, w, lastInstant, runArena, cache, pool);
+    }
+}
 
-        // Execute the process
-        for (int i = 0; i < current_process.service_time; ++i) {
-            output.push_back(current_process.name);
-        } 
 
-        current_time += current_process.service_time;
+//------------------------------------------------------------------------------------------------------------------------//
+//Compare mode
+// Walks the first algorithm's schedule against each of the others in lockstep, pulling one slice at a time from each
+// engine, and reports where they first hand the CPU to different processes. Neither schedule is ever stored, and
+// both engines are abandoned at lastInstant.
+
+struct schedule_agreement {
+    int first_divergence = -1; // -1 when the schedules never differ
+    long long same_ticks = 0;
+    int ticks = 0;
+};
+
+// One side of a comparison: an engine's slices, with jobs turned back into their processes when the workload has
+// I/O, as run_workload does
+struct compared_schedule {
+    std::optional<burst_arrivals> bursts;
+    workload_arrivals plain;
+    slice_generator engine;
+
+    compared_schedule(const algorithm& algo, const workload& w, arena& mem, int total_time) : plain(w) {
+        if (w.has_io() && algo.algorithm_id != 8) {
+            bursts.emplace(w);
+            engine = schedule(algo, bursts->jobs, *bursts, mem, total_time);
+        } else {
+            engine = schedule(algo, w, plain, mem, total_time);
+        }
     }
 
-    // Print final output
-    // // std::cout << "Output: ";
-    // for (const auto& p : output) {
-    //     std::cout << p << " ";
-    // }
-    // std::cout << "\n";
-    processes = backup_processes;
+    bool valid() const { return engine.valid(); }
+
+    bool next(slice& s) {
+        if (!engine.next(s)) return false;
+        if (bursts && s.process != IDLE) {
+            int job = s.process;
+            s.process = bursts->process_of[job];
+            if ((bursts->executed[job] += s.length) == bursts->jobs.service[job]) {
+                bursts->finished(job, s.start + s.length);
+            }
+        }
+        return true;
+    }
+};
 
-    return output;
+schedule_agreement compareSchedules(compared_schedule& a, compared_schedule& b, int horizon) {
+    schedule_agreement result;
+    slice x{IDLE, 0, 0};
+    slice y{IDLE, 0, 0};
+    int now = 0;
+    while (now < horizon) {
+        // Either schedule running out ends the comparison
+        while (x.start + x.length <= now) {
+            if (!a.next(x)) return result;
+        }
+        while (y.start + y.length <= now) {
+            if (!b.next(y)) return result;
+        }
+        int until = std::min({x.start + x.length, y.start + y.length, horizon});
+        if (x.process == y.process) {
+            result.same_ticks += until - now;
+        } else if (result.first_divergence < 0) {
+            result.first_divergence = now;
+        }
+        now = until;
+        result.ticks = now;
+    }
+    return result;
 }
-//------------------------------------------------------------------------------------------------------------------------//
 
-//Shortest Remaining Time
-std::vector<std::string> SRT(std::vector<process>& processes, std::vector<std::string>& output, int total_time) {
-    for (int current_time = 0; current_time < total_time; ++current_time) {
-        auto minProcessIt = std::min_element(
-            processes.begin(), processes.end(),
-            [current_time](const process& a, const process& b) {
-                if (a.remaining_service_time == 0 || a.arrival_time > current_time) return false;
-                if (b.remaining_service_time == 0 || b.arrival_time > current_time) return true;
-                return a.remaining_service_time < b.remaining_service_time;
-            });
+int runCompare(bool hugePages) {
+    std::string operation;
+    std::vector<algorithm> algorithms;
+    int lastInstant;
+    int numProcesses;
+    std::vector<process> processes;
+    parseInput(std::cin, operation, algorithms, lastInstant, processes, numProcesses);
+    if (algorithms.size() < 2) {
+        std::cerr << "Error: --compare needs at least two algorithms\n";
+        return 1;
+    }
 
-        if (minProcessIt == processes.end() || minProcessIt->remaining_service_time == 0) {
-            output.push_back("-"); // Idle time
-            continue;
+    const workload w = buildWorkload(processes);
+    arena runArena(2 * arenaBytes(w.size(), 0), hugePages);
+    std::string baseName = algorithmName(algorithms[0]);
+    for (size_t i = 1; i < algorithms.size(); ++i) {
+        std::string otherName = algorithmName(algorithms[i]);
+        {
+            compared_schedule base(algorithms[0], w, runArena, lastInstant);
+            compared_schedule other(algorithms[i], w, runArena, lastInstant);
+            if (!base.valid() || !other.valid()) {
+                std::cout << "Invalid Algorithm\n";
+            } else {
+                schedule_agreement agreement = compareSchedules(base, other, lastInstant);
+                std::cout << baseName << " vs " << otherName << ": same process on " << agreement.same_ticks
+                          << " of " << agreement.ticks << " ticks, ";
+                if (agreement.first_divergence < 0) {
+                    std::cout << "never diverge\n";
+                } else {
+                    std::cout << "first divergence at " << agreement.first_divergence << "\n";
+                }
+            }
         }
+        runArena.reset();
+    }
+    return 0;
+}
 
-        minProcessIt->remaining_service_time -= 1;
-        output.push_back(minProcessIt->name);
-        if (minProcessIt->remaining_service_time == 0) {
-            minProcessIt->finish_time = current_time + 1;
+//------------------------------------------------------------------------------------------------------------------------//
+//Chrome trace mode
+// Runs every algorithm of a normal input to completion and streams its schedule into one Chrome Trace Event file,
+// one trace process per algorithm. The schedules are never stored, so million-slice runs export in constant memory.
+int runChromeTrace(const std::string& path, bool hugePages) {
+    std::string operation;
+    std::vector<algorithm> algorithms;
+    int lastInstant;
+    int numProcesses;
+    std::vector<process> processes;
+    parseInput(std::cin, operation, algorithms, lastInstant, processes, numProcesses);
+
+    std::ofstream file;
+    if (path != "-") {
+        file.open(path);
+        if (!file) {
+            std::cerr << "Error: cannot write " << path << "\n";
+            return 1;
         }
     }
-    return output;
+    std::ostream& out = path == "-" ? std::cout : file;
+
+    const workload w = buildWorkload(processes);
+    arena runArena(arenaBytes(w.size(), 0), hugePages);
+    chrome_trace_writer writer(out);
+    for (size_t i = 0; i < algorithms.size(); ++i) {
+        chrome_trace_output sink(writer, w, i + 1, algorithmName(algorithms[i]), algorithms[i].algorithm_id != 8);
+        if (run_workload(algorithms[i], w, sink, runArena, lastInstant)) {
+            sink.close();
+        } else {
+            std::cerr << "Invalid Algorithm\n";
+        }
+        runArena.reset();
+    }
+    writer.finish();
+    out.flush();
+    if (!out) {
+        std::cerr << "Error: writing the trace failed\n";
+        return 1;
+    }
+    return 0;
 }
+
 //------------------------------------------------------------------------------------------------------------------------//
-//Feedback-1
-std::vector<std::string> FB_1(std::vector<process>& processes, std::vector<std::string>& output, int total_time) {
-    int numberofactiveprocesses = 0; // Maximum number of queues
-    int n = processes.size();       // Total number of processes
-    std::vector<process> backup_processes = processes;
-    std::vector<std::queue<process>> feedback_queues(n); // Feedback queues
-    int current_time = 0;
-    int process_index = 0; // Index to track processes
-
-    // Sort processes by arrival time initially
-    std::sort(processes.begin(), processes.end(), [](const process& a, const process& b) {
-        return a.arrival_time < b.arrival_time;
-    });
+//Schedule log
+// --record runs every algorithm of a normal input to completion and streams the schedules into a log (schedule_log.h)
+// instead of printing them. --replay maps a log and prints the trace or stats it holds for a window of time, decoding
+// only the records from the seek point before the window to its end.
 
-    while (current_time < total_time) {
-        while (process_index < n && processes[process_index].arrival_time <= current_time) {
-            feedback_queues[0].push(processes[process_index]);
-            numberofactiveprocesses++;
-            process_index++;
-        }
+int runRecord(const std::string& path, bool hugePages) {
+    std::string operation;
+    std::vector<algorithm> algorithms;
+    int lastInstant;
+    int numProcesses;
+    std::vector<process> processes;
+    parseInput(std::cin, operation, algorithms, lastInstant, processes, numProcesses);
 
-        bool process_executed = false;
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Error: cannot write " << path << "\n";
+        return 1;
+    }
+    const workload w = buildWorkload(processes);
+    arena runArena(arenaBytes(w.size(), 0), hugePages);
+    schedule_log_writer log(file, w, operation, lastInstant);
+    for (const auto& algo : algorithms) {
+        log.begin(algorithmName(algo), algo.algorithm_id != 8);
+        schedule_log_output sink{log};
+        if (!run_workload(algo, w, sink, runArena, lastInstant)) {
+            std::cerr << "Invalid Algorithm\n";
+        }
+        log.end(sink.now);
+        runArena.reset();
+    }
+    log.finish();
+    if (!file) {
+        std::cerr << "Error: writing the log failed\n";
+        return 1;
+    }
+    return 0;
+}
 
-        for (int i = 0; i < n; i++) {
-            if (!feedback_queues[i].empty()) {
-                process current_process = feedback_queues[i].front();
-                feedback_queues[i].pop();
+// Rows are the processes in the system at some point of [from, to): those that arrive before `to` and finish after
+// `from`, and those that arrive in the window without ever running. Times are shifted so the window starts at 0. A
+// window over the whole schedule shows every process, as the live trace does. False when the log is corrupt.
+bool replayTrace(std::ostream& out, const schedule_log_reader& log, const schedule_log_reader::section& s, int from,
+                 int to) {
+    std::string algoName = s.name;
+    bool aging = algoName == "Aging"; // Aging never finishes anything, so every arrived process stays on the trace
+    struct logged {
+        int id;
+        int start;
+        int length;
+        bool blocked;
+    };
+    std::vector<logged> decoded;
+    bool read = log.slices(s, from, to, [&](int id, int start, int length, bool blocked) {
+        decoded.push_back({id, start, length, blocked});
+    });
+    if (!read) return false;
+
+    std::vector<int> ids;
+    if (from == 0 && to >= s.length) {
+        ids.resize(log.n);
+        std::iota(ids.begin(), ids.end(), 0);
+    } else {
+        // Arrivals before a time are a prefix of the arrival order and finishes after one a suffix of the finish
+        // order, so both bounds are binary searches and only the shorter side is walked
+        bool corrupt = false;
+        auto arrivalAt = [&](int k) {
+            int id = log.by_arrival(k);
+            corrupt |= id < 0;
+            return id < 0 ? INT_MAX : log.arrival(id);
+        };
+        auto finishAt = [&](int k) {
+            int id = log.by_finish(s, k);
+            int finish = id < 0 ? -1 : log.finish(s, id);
+            corrupt |= finish < 0;
+            return finish;
+        };
+        auto firstWhere = [&](auto before) {
+            int lo = 0, hi = log.n;
+            while (lo < hi) {
+                int mid = (lo + hi) / 2;
+                if (before(mid)) lo = mid + 1;
+                else hi = mid;
+            }
+            return lo;
+        };
+        int arrivedInWindow = firstWhere([&](int k) { return arrivalAt(k) < from; });
+        int arrived = firstWhere([&](int k) { return arrivalAt(k) < to; });
+        int finishing = firstWhere([&](int k) { return finishAt(k) <= from; });
+        if (aging) arrivedInWindow = 0;
+        for (int k = arrivedInWindow; k < arrived; ++k) {
+            ids.push_back(log.by_arrival(k));
+        }
+        // Plus the processes that arrived earlier and are still in the system at `from`
+        if (!aging && arrivedInWindow < log.n - finishing) {
+            for (int k = 0; k < arrivedInWindow; ++k) {
+                int id = log.by_arrival(k);
+                if (id < 0 || log.finish(s, id) > from) ids.push_back(id);
+            }
+        } else if (!aging) {
+            for (int k = finishing; k < log.n; ++k) {
+                int id = log.by_finish(s, k);
+                if (id < 0 || log.arrival(id) < from) ids.push_back(id);
+            }
+        }
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+        if (corrupt || (!ids.empty() && ids.front() < 0)) return false;
+    }
+    // Every logged slice in the window belongs to a row unless the finish table disagrees with the records
+    auto local = [&](int id) {
+        auto at = std::lower_bound(ids.begin(), ids.end(), id);
+        return at != ids.end() && *at == id ? int(at - ids.begin()) : -1;
+    };
+    for (const logged& slice : decoded) {
+        if (local(slice.id) < 0) return false;
+    }
 
-                output.push_back(current_process.name);
-                current_process.remaining_service_time -= 1;
-                current_time += 1;
-                process_executed = true;
+    std::vector<process> shown(ids.size());
+    std::vector<process_stats> stats(ids.size());
+    for (size_t k = 0; k < ids.size(); ++k) {
+        int finish = log.finish(s, ids[k]);
+        if (!log.process_at(ids[k], shown[k]) || finish < 0) return false;
+        shown[k].arrival_time = std::max(shown[k].arrival_time, from) - from; // Earlier arrivals wait from tick 0
+        stats[k].finish_time = finish > 0 ? finish - from : 0;
+    }
+    const workload w = buildWorkload(shown);
+
+    io_waits blocked(ids.size());
+    arena runArena(std::size_t(to - from) * sizeof(int) + 4096);
+    {
+        timeline output(to - from, IDLE, arena_allocator<int>(runArena));
+        for (const logged& slice : decoded) {
+            int begin = std::max(slice.start, from) - from;
+            int end = std::min(slice.start + slice.length, to) - from;
+            if (slice.blocked) {
+                blocked[local(slice.id)].push_back({begin, end});
+            } else {
+                std::fill(output.begin() + begin, output.begin() + end, local(slice.id));
+            }
+        }
+        outputTrace(out, w, stats, output, algoName, from, &blocked);
+    }
+    return true;
+}
 
-                  while (process_index < n && processes[process_index].arrival_time <= current_time) {
-            feedback_queues[0].push(processes[process_index]);
-            numberofactiveprocesses++;
-            process_index++;
+// Stats of the processes whose last tick lies in [from, to), found by binary search over the finish order. False when
+// the log is corrupt.
+bool replayStats(std::ostream& out, const schedule_log_reader& log, const schedule_log_reader::section& s, int from,
+                 int to) {
+    bool corrupt = false;
+    auto finishAt = [&](int k) {
+        int id = log.by_finish(s, k);
+        int finish = id < 0 ? -1 : log.finish(s, id);
+        corrupt |= finish < 0;
+        return finish;
+    };
+    auto firstAtLeast = [&](int time) {
+        int lo = 0, hi = log.n;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (finishAt(mid) < time) lo = mid + 1;
+            else hi = mid;
         }
+        return lo;
+    };
+    std::vector<int> ids;
+    for (int k = firstAtLeast(from + 1), end = firstAtLeast(to + 1); k < end; ++k) {
+        ids.push_back(log.by_finish(s, k));
+    }
+    if (corrupt) return false;
+    if (ids.empty()) {
+        out << s.name << "\nNo process finishes in [" << from << ", " << to << ")\n\n";
+        return true;
+    }
+    std::sort(ids.begin(), ids.end());
 
-                if (current_process.remaining_service_time == 0) {
-                    numberofactiveprocesses--;
-                    current_process.finish_time = current_time;
-                }
-                else {
-                    if (i==0 && numberofactiveprocesses==1)
-                    {
-                        feedback_queues[i].push(current_process);
-                    }
+    std::vector<process> shown(ids.size());
+    std::vector<process_stats> stats(ids.size());
+    for (size_t k = 0; k < ids.size(); ++k) {
+        if (!log.process_at(ids[k], shown[k])) return false;
+        stats[k].finish_time = log.finish(s, ids[k]);
+    }
+    const workload w = buildWorkload(shown);
+    completeStats(w, stats);
+    outputStats(out, w, stats, s.name);
+    return true;
+}
 
-                    else if (i + 1 < n) {
-                            feedback_queues[i + 1].push(current_process);
-                    }
-                    else {
-                            feedback_queues[i].push(current_process);
-                        }
+// `to` defaults to the end of each schedule, and the window is clamped to it
+int runReplay(const std::string& path, int from, int to) {
+    schedule_log_reader log;
+    if (!log.open(path)) {
+        std::cerr << "Error: " << path << " is not a complete schedule log\n";
+        return 1;
+    }
+    from = std::max(0, from);
+    for (const auto& s : log.sections) {
+        int until = to < 0 ? s.length : std::min(to, s.length);
+        int begin = std::min(from, until);
+        bool read = true;
+        if (log.operation == "trace") {
+            read = replayTrace(std::cout, log, s, begin, until);
+        } else if (log.operation == "stats") {
+            read = replayStats(std::cout, log, s, begin, until);
+        } else {
+            std::cerr << "Invalid operation. Use 'trace' or 'stats'.\n";
+        }
+        if (!read) {
+            std::cerr << "Error: " << path << " is corrupt in the " << s.name << " schedule\n";
+            return 1;
+        }
+    }
+    return 0;
+}
 
-                }
+//------------------------------------------------------------------------------------------------------------------------//
+//Pipelined mode
+// Parsing, simulation and rendering run on three threads connected by SPSC rings: the parser streams processes in
+// arrival order to the simulator, which streams timeline slices to the renderer (this thread). The first algorithm
+// consumes the process stream directly; later algorithms replay the workload it collected. I/O bursts are not
+// supported: their wakeups share one timing wheel with the arrivals, which needs every arrival before the first
+// dispatch, so an input with burst lists is rejected before anything is printed.
+int runPipelined(bool hugePages) {
+    std::string operation;
+    std::vector<algorithm> algorithms;
+    int lastInstant;
+    int numProcesses;
+    parseHeader(std::cin, operation, algorithms, lastInstant, numProcesses);
+
+    spsc_ring<process> parsed(4096);
+    std::atomic<bool> outOfOrder{false};
+    std::atomic<bool> hasBursts{false};
+    std::thread parser([&]() {
+        std::string processLine;
+        int previousArrival = INT_MIN;
+        for (int i = 0; i < numProcesses && std::getline(std::cin, processLine); ++i) {
+            process proc;
+            if (!parseProcessLine(processLine, i + 1, proc)) continue;
+            if (proc.arrival_time < previousArrival) {
+                outOfOrder = true;
                 break;
             }
+            if (!proc.bursts.empty()) {
+                hasBursts = true;
+                break;
+            }
+            previousArrival = proc.arrival_time;
+            parsed.push(std::move(proc));
         }
+        parsed.close();
+    });
 
+    workload w;
+    w.names.reserve(numProcesses);
+    w.arrival.reserve(numProcesses);
+    w.service.reserve(numProcesses);
+    w.by_arrival.reserve(numProcesses);
+    w.sorted_arrival.reserve(numProcesses);
+    w.sorted_service.reserve(numProcesses);
+
+    spsc_ring<slice> slices(1 << 14);
+    std::thread simulator([&]() {
+        arena runArena(arenaBytes(numProcesses, lastInstant), hugePages);
+        for (size_t a = 0; a < algorithms.size(); ++a) {
+            ring_output output(slices);
+            if (a == 0) {
+                stream_arrivals arrivals(parsed, w, numProcesses);
+                apply_algorithm(algorithms[a], w, arrivals, output, runArena, lastInstant);
+                arrivals.drain();
+                // The parser is done once the stream is drained; a rejected input is not run any further
+                if (outOfOrder || hasBursts) {
+                    output.finish();
+                    break;
+                }
+            } else {
+                workload_arrivals arrivals(w);
+                apply_algorithm(algorithms[a], w, arrivals, output, runArena, lastInstant);
+            }
+            output.finish();
+            runArena.reset();
+        }
+        slices.close();
+    });
 
-        if (!process_executed) {
-            current_time++;
+    arena renderArena(arenaBytes(0, 4 * (size_t)lastInstant), hugePages);
+    std::vector<process_stats> stats;
+    for (const auto& algo : algorithms) {
+        std::string algoName = algorithmName(algo);
+        {
+            timeline output{arena_allocator<int>(renderArena)};
+            output.reserve(lastInstant + 1);
+            slice s;
+            while (slices.pop(s) && s.process != END_OF_RUN) {
+                output.insert(output.end(), s.length, s.process);
+            }
+            // The end marker is pushed after the run finished with the workload, so it is complete here
+            if (outOfOrder || hasBursts) break;
+            calculateStatsFromOutput(w, output, stats);
+            if (algoName == "Unknown") {
+                std::cout << "Invalid Algorithm\n";
+            }
+            printResult(std::cout, operation, w, stats, output, algoName);
         }
+        renderArena.reset();
     }
 
-    processes = backup_processes; // Restore original process list
-    return output;
+    parser.join();
+    simulator.join();
+    if (outOfOrder) {
+        std::cerr << "Error: --pipeline needs the processes listed in arrival order\n";
+        return 1;
+    }
+    if (hasBursts) {
+        std::cerr << "Error: --pipeline does not run I/O bursts, run the input without it\n";
+        return 1;
+    }
+    return 0;
 }
 
-
 //------------------------------------------------------------------------------------------------------------------------//
-//Feedback-2i
-std::vector<std::string> FB_2i(std::vector<process>& processes, std::vector<std::string>& output, int total_time) {
-    int numberofactiveprocesses = 0; // Maximum number of queues
-    int n = processes.size();       // Total number of processes
-    std::vector<process> backup_processes = processes;
-    std::vector<std::queue<process>> feedback_queues(n); // Feedback queues
-    int current_time = 0;
-    int process_index = 0; // Index to track processes
-
-    // Sort processes by arrival time initially
-    std::sort(processes.begin(), processes.end(), [](const process& a, const process& b) {
-        return a.arrival_time < b.arrival_time;
-    });
+//Online mode
+// Drives one engine from a live event feed on stdin instead of a complete input file. The first line names the
+// algorithm ("2-4"), then each line is either an arrival "name,arrival,service" or a heartbeat "@T" promising that
+// nothing else arrives before T. Arrivals must come in non-decreasing time order. Dispatches and completions are
+// written as soon as the engine can determine them, which is whenever the next event tells it that no earlier
+// arrival is still to come.
+
+// Arrivals read straight from the feed. Every event is timed from the moment it is read until the engine comes back
+// for the next one, which is the time it took to make every decision that event unblocked.
+struct online_arrivals {
+    std::istream& in;
+    workload& w;
+    int declared;
+    process lookahead;
+    bool has_lookahead = false;
+    bool closed = false;
+    bool rejected = false; // The feed was cut short by an event that cannot be run
+    int clock = INT_MIN; // Nothing else arrives before this time
+    int line_number = 1;
+
+    std::chrono::steady_clock::time_point event_read;
+    bool timing_event = false;
+    std::vector<double> latencies_us;
+
+    online_arrivals(std::istream& in, workload& w, int declared) : in(in), w(w), declared(declared) {}
+
+    int capacity() const { return declared; }
+
+    bool exhausted() {
+        while (!has_lookahead && !closed) readEvent();
+        return !has_lookahead;
+    }
+
+    // Does not wait for the feed: until the next arrival is read, the last heartbeat is all that is known
+    int next_arrival() const {
+        if (has_lookahead) return lookahead.arrival_time;
+        return closed ? INT_MAX : clock;
+    }
+
+    bool pop_arrived(int now, int& id) {
+        while (!has_lookahead && !closed && clock <= now) readEvent();
+        if (!has_lookahead || lookahead.arrival_time > now) return false;
+        return pop(id);
+    }
 
-    // Define time quantum for each feedback queue level
-    std::vector<int> time_quantum(n);
-    for (int i = 0; i < n; i++) {
-        time_quantum[i] = (1 << i); // Time quantum doubles at each lower-priority level
+    bool pop(int& id) {
+        if (exhausted()) return false;
+        id = appendProcess(w, lookahead);
+        has_lookahead = false;
+        return true;
     }
 
-    while (current_time < total_time) {
-        // Add newly arrived processes to the first feedback queue
-        while (process_index < n && processes[process_index].arrival_time <= current_time) {
-            feedback_queues[0].push(processes[process_index]);
-            numberofactiveprocesses++;
-            process_index++;
+    // The engine is done with the current event
+    void finishEvent() {
+        if (!timing_event) return;
+        latencies_us.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - event_read).count());
+        timing_event = false;
+    }
+
+    void readEvent() {
+        finishEvent();
+        std::cout.flush();
+
+        std::string line;
+        if (!std::getline(in, line)) {
+            closed = true;
+            return;
+        }
+        event_read = std::chrono::steady_clock::now();
+        timing_event = true;
+        ++line_number;
+
+        if (line.empty()) return;
+        if (line[0] == '@') {
+            clock = std::max(clock, std::stoi(line.substr(1)));
+            return;
+        }
+
+        process proc;
+        if (!parseProcessLine(line, line_number, proc)) return;
+        if (!proc.bursts.empty()) {
+            // Bursts wake on a timing wheel shared with the arrivals, which a live feed cannot fill in advance
+            std::cerr << "Error: line " << line_number << ": online mode does not run I/O bursts, stopping at "
+                      << proc.name << "\n";
+            rejected = true;
+            closed = true;
+            return;
+        }
+        if (proc.arrival_time < clock) {
+            std::cerr << "Error: arrival at " << proc.arrival_time << " is earlier than time " << clock
+                      << " already passed, ignoring " << proc.name << "\n";
+            return;
+        }
+        if (w.size() >= declared) {
+            std::cerr << "Error: more than " << declared << " processes, raise --max-processes\n";
+            closed = true;
+            return;
+        }
+        clock = proc.arrival_time;
+        lookahead = proc;
+        has_lookahead = true;
+    }
+};
+
+// Prints every change of running process and every completion, with turnaround statistics over the last
+// `window` completions
+struct online_output {
+    const workload& w;
+    arena_vector<int> executed;
+    bool report_completions;
+    int window;
+    std::vector<int> recent_turnaround;
+    std::vector<float> recent_norm;
+    long long window_turnaround = 0;
+    double window_norm = 0.0;
+    int completions = 0;
+    int now = 0;
+    int running = END_OF_RUN; // Nothing printed yet
+
+    online_output(const workload& w, arena& mem, int capacity, bool report_completions, int window)
+        : w(w), executed(capacity, 0, arena_allocator<int>(mem)), report_completions(report_completions),
+          window(window), recent_turnaround(window), recent_norm(window) {}
+
+    void emit(int id, int count) {
+        if (count <= 0) return;
+        if (id != running) {
+            if (id == IDLE) {
+                std::cout << now << " idle\n";
+            } else {
+                std::cout << now << " dispatch " << w.names[id] << "\n";
+            }
+            running = id;
+        }
+        now += count;
+        if (id != IDLE && report_completions) {
+            executed[id] += count;
+            if (executed[id] == w.service[id]) complete(id);
         }
+    }
 
-        bool process_executed = false;
+    void complete(int id) {
+        int turnaround = now - w.arrival[id];
+        float norm = static_cast<float>(turnaround) / w.service[id];
 
-        // Iterate over feedback queues
-        for (int i = 0; i < n; i++) {
-            if (!feedback_queues[i].empty()) {
-                process current_process = feedback_queues[i].front();
-                feedback_queues[i].pop();
+        // Slide the window: the oldest completion drops out once it is full
+        int slot = completions % window;
+        if (completions >= window) {
+            window_turnaround -= recent_turnaround[slot];
+            window_norm -= recent_norm[slot];
+        }
+        recent_turnaround[slot] = turnaround;
+        recent_norm[slot] = norm;
+        window_turnaround += turnaround;
+        window_norm += norm;
+        completions++;
+
+        int inWindow = std::min(completions, window);
+        std::cout << now << " complete " << w.names[id] << " turnaround " << turnaround << " normturn "
+                  << std::fixed << std::setprecision(2) << norm << " window_mean_turnaround "
+                  << static_cast<double>(window_turnaround) / inWindow << " window_mean_normturn "
+                  << window_norm / inWindow << "\n";
+    }
+};
 
-                // Execute the process for the time quantum or until it finishes
-                int quantum = time_quantum[i];
-                int time_slice = std::min(quantum, current_process.remaining_service_time);
+int runOnline(bool hugePages, int maxProcesses, int horizon, int window) {
+    std::string algorithmToken;
+    if (!std::getline(std::cin, algorithmToken) || algorithmToken.empty()) {
+        std::cerr << "Error: online mode expects the algorithm on the first line\n";
+        return 1;
+    }
+    algorithm algo = parseAlgorithm(algorithmToken);
 
-                for (int t = 0; t < time_slice; t++) {
-                    output.push_back(current_process.name);
-                    current_process.remaining_service_time--;
-                    current_time++;
+    // Aging never completes anything, so without a horizon it would run forever
+    bool isAging = algo.algorithm_id == 8;
+    if (isAging && horizon == UNTIL_DRAINED) {
+        std::cerr << "Error: Aging needs --horizon in online mode\n";
+        return 1;
+    }
 
-                    while (process_index < n && processes[process_index].arrival_time <= current_time) {
-                        feedback_queues[0].push(processes[process_index]);
-                        numberofactiveprocesses++;
-                        process_index++;
-                    }
-                }
+    workload w;
+    arena runArena(arenaBytes(maxProcesses, 0), hugePages);
+    online_arrivals arrivals(std::cin, w, maxProcesses);
+    online_output output(w, runArena, maxProcesses, !isAging, window);
 
-                process_executed = true;
+    if (!apply_algorithm(algo, w, arrivals, output, runArena, horizon)) {
+        std::cerr << "Error: unknown algorithm " << algorithmToken << "\n";
+        return 1;
+    }
+    arrivals.finishEvent();
+    std::cout.flush();
+
+    // Decision latency report
+    std::vector<double>& lat = arrivals.latencies_us;
+    if (!lat.empty()) {
+        double sum = 0.0;
+        for (double l : lat) sum += l;
+        std::sort(lat.begin(), lat.end());
+        auto percentile = [&lat](double p) { return lat[std::min(lat.size() - 1, (size_t)(p * lat.size()))]; };
+        std::cerr << std::fixed << std::setprecision(1) << "online: " << lat.size()
+                  << " events, decision latency us: mean " << sum / lat.size() << " p50 " << percentile(0.50)
+                  << " p99 " << percentile(0.99) << " max " << lat.back() << "\n";
+    }
+    return arrivals.rejected ? 1 : 0;
+}
 
-                // Check if the process is finished
-                if (current_process.remaining_service_time == 0) {
-                    numberofactiveprocesses--;
-                    current_process.finish_time = current_time;
-                } else {
-                    if (i==0 && numberofactiveprocesses==1) {
-                        feedback_queues[i].push(current_process);
-                    } else
-                    if (i + 1 < n) {
-                        feedback_queues[i + 1].push(current_process);
-                    } else {
-                        feedback_queues[i].push(current_process);
-                    }
-                }
 
-                break; 
-            }
+//------------------------------------------------------------------------------------------------------------------------//
+//Server mode
+// Listens on a Unix domain socket so repeated small runs skip process startup. A client writes one input in the
+// usual text format, shuts down its writing side and reads back exactly what the binary would have printed.
+// Connections are handed to a pool of workers, each of which keeps its own arena warm between requests.
+
+// Accepted connections waiting for a worker; -1 tells a worker to stop
+struct connection_queue {
+    std::mutex lock;
+    std::condition_variable ready;
+    std::queue<int> fds;
+
+    void push(int fd) {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            fds.push(fd);
         }
+        ready.notify_one();
+    }
+
+    int pop() {
+        std::unique_lock<std::mutex> guard(lock);
+        ready.wait(guard, [this]() { return !fds.empty(); });
+        int fd = fds.front();
+        fds.pop();
+        return fd;
+    }
+};
 
-        if (!process_executed) {
-            current_time++;
+bool readAll(int fd, std::string& data) {
+    char buffer[1 << 16];
+    while (true) {
+        ssize_t got = read(fd, buffer, sizeof(buffer));
+        if (got == 0) return true;
+        if (got < 0) {
+            if (errno == EINTR) continue;
+            return false;
         }
+        data.append(buffer, got);
     }
+}
 
-    processes = backup_processes; // Restore original process list
-    return output;
+bool writeAll(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t put = write(fd, data.data() + sent, data.size() - sent);
+        if (put < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        sent += put;
+    }
+    return true;
 }
 
-// Algorithm Applying
-std::vector<std::string> apply_algorithm(const algorithm& algo, std::vector<process>& processes, int total_time) {
-    std::vector<std::string> output;
-    switch (algo.algorithm_id) {
+void serveConnection(int fd, arena& warmArena) {
+    std::string request;
+    if (readAll(fd, request)) {
+        std::istringstream in(request);
+        std::ostringstream out;
+        // A malformed number makes std::stoi throw; that must not take the whole server down
+        try {
+            runBatch(in, out, warmArena);
+        } catch (const std::exception& e) {
+            warmArena.reset();
+            out << "Error: " << e.what() << "\n";
+        }
+        writeAll(fd, out.str());
+    }
+    close(fd);
+}
 
-        case 1:
-            output = fcfs(processes,output);
-            break;
-        case 2:
-            output = RR(processes, output, algo.quantum);
-            break;
-        case 3:
-            output = SPN(processes, output);
-            break;
-        case 4:
-            output = SRT(processes, output, total_time);
-            break;
-        case 5:
-            output = HRRN(processes, output);
-            break;
-        case 6:
-            // printf("FB-1\n");
+int runServer(const char* path, int workers, bool hugePages) {
+    signal(SIGPIPE, SIG_IGN); // A client hanging up early must not kill the server
 
-            output = FB_1(processes, output,total_time);
-            break;
-        case 7:
-            output = FB_2i(processes, output,total_time);
-            break;
-        case 8:
-            output = aging(processes, total_time, algo.quantum, output);
-            break;
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (std::strlen(path) >= sizeof(address.sun_path)) {
+        std::cerr << "Error: socket path too long: " << path << "\n";
+        return 1;
+    }
+    std::strcpy(address.sun_path, path);
 
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        perror("socket");
+        return 1;
+    }
+    unlink(path);
+    if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(listener, 128) < 0) {
+        perror(path);
+        close(listener);
+        return 1;
+    }
 
-        default:
-        std::cout <<"Invalid Algorithm\n";
+    connection_queue pending;
+    std::vector<std::thread> pool;
+    for (int i = 0; i < workers; ++i) {
+        pool.emplace_back([&pending, hugePages]() {
+            arena warmArena(0, hugePages);
+            for (int fd = pending.pop(); fd >= 0; fd = pending.pop()) {
+                serveConnection(fd, warmArena);
+            }
+        });
+    }
 
+    std::cerr << "serving on " << path << " with " << workers << " workers\n";
+    while (true) {
+        int fd = accept(listener, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            perror("accept");
+            break;
+        }
+        pending.push(fd);
+    }
 
-        break;
+    for (size_t i = 0; i < pool.size(); ++i) {
+        pending.push(-1);
+    }
+    for (auto& worker : pool) {
+        worker.join();
     }
-    calculateStatsFromOutput(output, processes);
-    return output;
+    close(listener);
+    unlink(path);
+    return 1;
 }
 
 
 //------------------------------------------------------------------------------------------------------------------------//
-//main
-int main() {
+//Multi-file batch mode
+// Runs many input files at once. Parsing a file is one task; once parsed it fans out one task per algorithm, so a
+// huge file's algorithms spread over idle workers while small files finish alongside. The last algorithm of a file
+// to finish writes that file's output, with the sections in the order the input listed them.
+
+struct batch_file {
+    std::string input_path;
+    std::string output_path;
     std::string operation;
     std::vector<algorithm> algorithms;
-    int lastInstant;
-    int numProcesses;
-    std::vector<process> processes;
-    parseInput(operation, algorithms, lastInstant, processes, numProcesses);
+    int lastInstant = 0;
+    workload w;
+    std::vector<std::string> sections; // Rendered output of each algorithm
+    std::atomic<int> remaining{0};
+    bool failed = false;
+};
 
-    // Create a backup of the initial processes vector
-    std::vector<process> initialProcesses = processes;
+// Directories contribute their *-input.txt files; anything else is taken as an input file itself
+std::vector<std::string> collectBatchInputs(const std::vector<std::string>& paths) {
+    namespace fs = std::filesystem;
+    std::vector<std::string> inputs;
+    for (const auto& path : paths) {
+        std::error_code error;
+        if (fs::is_directory(path, error)) {
+            std::vector<std::string> found;
+            for (const auto& entry : fs::directory_iterator(path, error)) {
+                std::string name = entry.path().filename().string();
+                if (entry.is_regular_file() && name.size() > 10 && name.compare(name.size() - 10, 10, "-input.txt") == 0) {
+                    found.push_back(entry.path().string());
+                }
+            }
+            std::sort(found.begin(), found.end());
+            inputs.insert(inputs.end(), found.begin(), found.end());
+        } else {
+            inputs.push_back(path);
+        }
+    }
+    return inputs;
+}
 
-    for (const auto& algo : algorithms) {
-        std::string algoName;
+// 01a-input.txt becomes 01a-output.txt in the output directory; other names get ".out" appended
+std::string batchOutputPath(const std::string& inputPath, const std::string& outputDir) {
+    std::string name = std::filesystem::path(inputPath).filename().string();
+    size_t pos = name.rfind("-input");
+    if (pos != std::string::npos) {
+        name.replace(pos, 6, "-output");
+    } else {
+        name += ".out";
+    }
+    return (std::filesystem::path(outputDir) / name).string();
+}
 
-        switch (algo.algorithm_id) {
-            case 1:
-                algoName = "FCFS";
-                break;
-            case 2:
-                algoName = "RR";
-                break;
-            case 3:
-                algoName = "SPN";
-                break;
-            case 4:
-                algoName = "SRT";
-                break;
-            case 5:
-                algoName = "HRRN";
-                break;
-            case 6:
-                algoName = "FB-1";
-                break;
-            case 7:
-                algoName = "FB-2i";
-                break;
-            case 8:
-                algoName = "Aging";
-                break;
-            default:
-                algoName = "Unknown";
-                break;
+int runMultiBatch(const std::vector<std::string>& paths, const std::string& outputDir, int workers, bool hugePages,
+                  result_cache& cache) {
+    std::vector<std::string> inputs = collectBatchInputs(paths);
+    if (inputs.empty()) {
+        std::cerr << "Error: no input files found\n";
+        return 1;
+    }
+    std::error_code error;
+    std::filesystem::create_directories(outputDir, error);
+    if (error) {
+        std::cerr << "Error: cannot create " << outputDir << ": " << error.message() << "\n";
+        return 1;
+    }
+
+    std::vector<std::unique_ptr<batch_file>> files;
+    for (const auto& input : inputs) {
+        files.emplace_back(new batch_file);
+        files.back()->input_path = input;
+        files.back()->output_path = batchOutputPath(input, outputDir);
+    }
+
+    // One warm arena per worker; a worker only ever touches its own
+    std::vector<std::unique_ptr<arena>> arenas;
+    for (int i = 0; i < workers; ++i) {
+        arenas.emplace_back(new arena(0, hugePages));
+    }
+    std::atomic<long long> ticksSimulated{0};
+    std::atomic<long long> processesRun{0};
+    std::atomic<int> tasksRun{0};
+    std::atomic<int> failedFiles{0};
+
+    auto writeOutput = [&failedFiles](batch_file& file) {
+        std::ofstream out(file.output_path);
+        for (const auto& section : file.sections) {
+            out << section;
+        }
+        if (!out) {
+            std::cerr << "Error: cannot write " << file.output_path << "\n";
+            failedFiles++;
         }
-        if (algoName == "RR") {
-            algoName = algoName + "-" + std::to_string(algo.quantum);
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        work_stealing_pool pool(workers);
+        for (auto& owned : files) {
+            batch_file* file = owned.get();
+            pool.submit([&, file](int) {
+                std::ifstream in(file->input_path);
+                if (!in) {
+                    std::cerr << "Error: cannot read " << file->input_path << "\n";
+                    failedFiles++;
+                    return;
+                }
+                int numProcesses;
+                std::vector<process> processes;
+                try {
+                    parseInput(in, file->operation, file->algorithms, file->lastInstant, processes, numProcesses);
+                } catch (const std::exception& e) {
+                    std::cerr << "Error: " << file->input_path << ": " << e.what() << "\n";
+                    failedFiles++;
+                    return;
+                }
+                file->w = buildWorkload(processes);
+                file->sections.resize(file->algorithms.size());
+                file->remaining = file->algorithms.size();
+                tasksRun++;
+                if (file->algorithms.empty()) {
+                    writeOutput(*file);
+                    return;
+                }
+
+                for (size_t a = 0; a < file->algorithms.size(); ++a) {
+                    pool.submit([&, file, a](int worker) {
+                        std::ostringstream out;
+                        int ticks = runAlgorithm(out, file->operation, file->algorithms[a], file->w, file->lastInstant,
+                                                 *arenas[worker], &cache);
+                        file->sections[a] = out.str();
+                        ticksSimulated += ticks;
+                        processesRun += file->w.size();
+                        tasksRun++;
+                        if (--file->remaining == 0) {
+                            writeOutput(*file);
+                        }
+                    });
+                }
+            });
         }
+        pool.wait();
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cerr << std::fixed << std::setprecision(3) << "batch: " << files.size() << " files, " << tasksRun.load()
+                  << " tasks on " << workers << " workers (" << pool.steals() << " stolen) in " << seconds << " s\n"
+                  << std::setprecision(0) << "batch: " << files.size() / seconds << " files/s, "
+                  << ticksSimulated.load() / seconds << " ticks/s, " << processesRun.load() / seconds
+                  << " process-runs/s\n";
+    }
+    return failedFiles.load() ? 1 : 0;
+}
+
 
-        // Restore the processes vector to its initial state
-        processes = initialProcesses;
+//------------------------------------------------------------------------------------------------------------------------//
+//main
 
-        // Apply the algorithm
-        std::vector<std::string> output = apply_algorithm(algo, processes, lastInstant);
+// $XDG_CACHE_HOME/cpu-scheduling-simulation, falling back to ~/.cache; empty when neither is set
+std::string defaultCacheDir() {
+    const char* base = std::getenv("XDG_CACHE_HOME");
+    if (base && *base) return std::string(base) + "/cpu-scheduling-simulation";
+    const char* home = std::getenv("HOME");
+    if (home && *home) return std::string(home) + "/.cache/cpu-scheduling-simulation";
+    return "";
+}
 
-        if (operation == "trace") {
-            outputTrace(processes, output, algoName);
-        } else if (operation == "stats") {
-            outputStats(processes, algoName);
+int main(int argc, char* argv[]) {
+    bool hugePages = false;
+    bool pipelined = false;
+    bool online = false;
+    bool compare = false;
+    bool parallel = false;
+    int maxProcesses = 1 << 20;
+    int horizon = UNTIL_DRAINED;
+    int window = 100;
+    const char* socketPath = nullptr;
+    const char* chromeTrace = nullptr;
+    const char* recordPath = nullptr;
+    const char* replayPath = nullptr;
+    int replayFrom = 0;
+    int replayTo = -1; // End of each schedule
+    std::vector<std::string> batchPaths;
+    std::string outputDir = "batch_output";
+    int workers = std::max(1u, std::thread::hardware_concurrency());
+    bool useCache = false;
+    std::string cacheDir = defaultCacheDir();
+    long long cacheMegabytes = 256;
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--huge-pages") == 0) {
+            hugePages = true;
+        } else if (std::strcmp(argv[i], "--pipeline") == 0) {
+            pipelined = true;
+        } else if (std::strcmp(argv[i], "--online") == 0) {
+            online = true;
+        } else if (std::strcmp(argv[i], "--compare") == 0) {
+            compare = true;
+        } else if (std::strcmp(argv[i], "--parallel") == 0) {
+            parallel = true;
+        } else if (std::strcmp(argv[i], "--chrome-trace") == 0 && hasValue) {
+            chromeTrace = argv[++i];
+        } else if (std::strcmp(argv[i], "--record") == 0 && hasValue) {
+            recordPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--replay") == 0 && hasValue) {
+            replayPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--from") == 0 && hasValue) {
+            replayFrom = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--to") == 0 && hasValue) {
+            replayTo = std::max(0, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--max-processes") == 0 && hasValue) {
+            maxProcesses = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--horizon") == 0 && hasValue) {
+            horizon = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--window") == 0 && hasValue) {
+            window = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--serve") == 0 && hasValue) {
+            socketPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--workers") == 0 && hasValue) {
+            workers = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--batch") == 0 && hasValue) {
+            batchPaths.push_back(argv[++i]);
+        } else if (std::strcmp(argv[i], "--output-dir") == 0 && hasValue) {
+            outputDir = argv[++i];
+        } else if (std::strcmp(argv[i], "--cache") == 0) {
+            useCache = true;
+        } else if (std::strcmp(argv[i], "--no-cache") == 0) {
+            useCache = false;
+        } else if (std::strcmp(argv[i], "--cache-dir") == 0 && hasValue) {
+            cacheDir = argv[++i];
+        } else if (std::strcmp(argv[i], "--cache-size") == 0 && hasValue) {
+            cacheMegabytes = std::max(0LL, std::atoll(argv[++i]));
         } else {
-            std::cerr << "Invalid operation. Use 'trace' or 'stats'.\n";
+            std::cerr << "Unknown option: " << argv[i] << "\n";
+            return 1;
         }
     }
 
+    result_cache cache(useCache ? cacheDir : std::string(), std::uintmax_t(cacheMegabytes) << 20);
+    if (!batchPaths.empty()) {
+        return runMultiBatch(batchPaths, outputDir, workers, hugePages, cache);
+    }
+    if (socketPath) {
+        return runServer(socketPath, workers, hugePages);
+    }
+    if (online) {
+        return runOnline(hugePages, maxProcesses, horizon, window);
+    }
+    if (compare) {
+        return runCompare(hugePages);
+    }
+    if (chromeTrace) {
+        return runChromeTrace(chromeTrace, hugePages);
+    }
+    if (recordPath) {
+        return runRecord(recordPath, hugePages);
+    }
+    if (replayPath) {
+        return runReplay(replayPath, replayFrom, replayTo);
+    }
+    if (pipelined) {
+        return runPipelined(hugePages);
+    }
+
+    arena runArena(0, hugePages);
+    std::unique_ptr<work_stealing_pool> pool(parallel ? new work_stealing_pool(workers) : nullptr);
+    runBatch(std::cin, std::cout, runArena, &cache, pool.get());
     return 0;
 }
-
@@ -0,0 +1,238 @@
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <unistd.h>
+#include <vector>
+#include "scheduler.h"
+
+//------------------------------------------------------------------------------------------------------------------------//
+//Result cache
+// Finished runs stored on disk under a hash of everything that decides the schedule: the workload's scheduling
+// columns, the algorithm descriptor, lastInstant and ENGINE_VERSION. Names are left out of the hash, since
+// they only change how a result is printed. An entry holds the finish times and, once a trace run has produced
+// one, the timeline as (process, length) runs. Entries are written to a temporary file and renamed into place, so
+// concurrent writers never expose half an entry. Reading an entry refreshes its modification time, which is what
+// eviction goes by: once the directory outgrows its budget the least recently used entries are removed first.
+
+// What a run leaves behind for later runs of the same key
+struct cached_result {
+    std::vector<int> finish;                      // Finish time of each process
+    int ticks = 0;                                // Length of the schedule
+    bool has_timeline = false;
+    std::vector<std::pair<int, int>> runs;        // (process or IDLE, length) covering the timeline in order
+};
+
+class result_cache {
+public:
+    // An empty directory disables the cache
+    result_cache(const std::string& directory, std::uintmax_t max_bytes) : dir(directory), budget(max_bytes) {
+        if (dir.empty()) return;
+        std::error_code error;
+        std::filesystem::create_directories(dir, error);
+        if (error) return;
+        usable = true;
+        used = scan(nullptr);
+    }
+
+    result_cache(const result_cache&) = delete;
+    result_cache& operator=(const result_cache&) = delete;
+
+    bool enabled() const { return usable; }
+
+    static std::string key(const workload& w, const algorithm& algo, int lastInstant) {
+        hasher h;
+        h.add(FORMAT);
+        h.add(ENGINE_VERSION);
+        h.add(algo);
+        h.add(lastInstant);
+        h.add(w.arrival);
+        h.add(w.service);
+        h.add(w.burst_start);
+        h.add(w.bursts);
+        h.add(w.tickets);
+        h.add(w.deadlines);
+        h.add(w.class_ids);
+        h.add(w.group_ids);
+        h.add(w.group_parent);
+        h.add(w.group_weight);
+        char text[33];
+        std::snprintf(text, sizeof(text), "%016llx%016llx", (unsigned long long)h.a, (unsigned long long)h.b);
+        return text;
+    }
+
+    // A stats run can use any entry; a trace run needs one with the timeline. An entry that does not describe a
+    // schedule of n processes at most maxTicks long is removed.
+    bool load(const std::string& key, int n, int maxTicks, bool needTimeline, cached_result& result) {
+        if (!usable) return false;
+        std::filesystem::path path = entryPath(key);
+        std::ifstream in(path, std::ios::binary);
+        if (!in) return false;
+
+        // Read into a fresh entry, so a rejected one leaves nothing behind in result for the run to append to
+        cached_result entry;
+        std::int32_t header[4]; // magic, process count, ticks, has_timeline
+        if (!read(in, header, 4) || header[0] != MAGIC || header[1] != n) return reject(path);
+        if (needTimeline && !header[3]) return false;
+        if (header[2] < 0 || header[2] > maxTicks) return reject(path);
+        entry.finish.resize(n);
+        entry.ticks = header[2];
+        entry.has_timeline = header[3];
+        if (!read(in, entry.finish.data(), n)) return reject(path);
+        for (int finish : entry.finish) {
+            if (finish < 0 || finish > entry.ticks) return reject(path);
+        }
+        if (entry.has_timeline) {
+            std::int64_t count;
+            if (!in.read(reinterpret_cast<char*>(&count), sizeof(count)) || count < 0 || count > entry.ticks) {
+                return reject(path);
+            }
+            entry.runs.resize(count);
+            if (!in.read(reinterpret_cast<char*>(entry.runs.data()), count * sizeof(entry.runs[0]))) return reject(path);
+            long long covered = 0;
+            for (const auto& run : entry.runs) {
+                if (run.first < -1 || run.first >= n || run.second <= 0) return reject(path);
+                covered += run.second;
+            }
+            if (covered != entry.ticks) return reject(path);
+        }
+        if (in.peek() != std::ifstream::traits_type::eof()) return reject(path);
+
+        std::error_code error;
+        std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), error);
+        result = std::move(entry);
+        return true;
+    }
+
+    void store(const std::string& key, const cached_result& result) {
+        if (!usable) return;
+        std::int32_t header[4] = {MAGIC, (std::int32_t)result.finish.size(), result.ticks, result.has_timeline};
+        std::int64_t count = result.runs.size();
+        std::uintmax_t bytes = sizeof(header) + result.finish.size() * sizeof(int)
+                             + (result.has_timeline ? sizeof(count) + count * sizeof(result.runs[0]) : 0);
+        if (bytes > budget) return;
+
+        std::filesystem::path path = entryPath(key);
+        std::filesystem::path temporary = path;
+        temporary += ".tmp" + std::to_string(getpid()) + "-" +
+                     std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+        {
+            std::ofstream out(temporary, std::ios::binary);
+            out.write(reinterpret_cast<const char*>(header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(result.finish.data()), result.finish.size() * sizeof(int));
+            if (result.has_timeline) {
+                out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+                out.write(reinterpret_cast<const char*>(result.runs.data()), count * sizeof(result.runs[0]));
+            }
+            if (!out) {
+                std::error_code error;
+                std::filesystem::remove(temporary, error);
+                return;
+            }
+        }
+        std::error_code error;
+        std::uintmax_t replaced = std::filesystem::exists(path, error) ? std::filesystem::file_size(path, error) : 0;
+        std::filesystem::rename(temporary, path, error);
+        if (error) {
+            std::filesystem::remove(temporary, error);
+            return;
+        }
+
+        std::lock_guard<std::mutex> guard(lock);
+        used = used + bytes > replaced ? used + bytes - replaced : 0;
+        if (used > budget) evict();
+    }
+
+private:
+    static const std::int32_t MAGIC = 0x31484353; // "SCH1"
+    static const int FORMAT = 1;
+
+    // Two independent 64-bit lanes: FNV-1a over 32-bit words and a multiply-xorshift mix
+    struct hasher {
+        std::uint64_t a = 14695981039346656037ull;
+        std::uint64_t b = 0x9E3779B97F4A7C15ull;
+
+        void add(long long value) {
+            a = (a ^ (std::uint32_t)value) * 1099511628211ull;
+            a = (a ^ (std::uint32_t)((unsigned long long)value >> 32)) * 1099511628211ull;
+            std::uint64_t x = b ^ (std::uint64_t)value;
+            x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+            x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+            b = x ^ (x >> 31);
+        }
+        void add(const std::vector<int>& values) {
+            add((long long)values.size());
+            for (int v : values) add(v);
+        }
+        void add(const algorithm& algo) {
+            add(algo.algorithm_id);
+            add(algo.quantum);
+            add((long long)algo.seed);
+            add((long long)algo.classes.size());
+            for (const algorithm& policy : algo.classes) add(policy);
+            add(algo.class_weights);
+        }
+    };
+
+    std::filesystem::path entryPath(const std::string& key) const { return dir / (key + ".bin"); }
+
+    // Deletes a corrupt or truncated entry; always false so load can return it
+    bool reject(const std::filesystem::path& path) {
+        std::error_code error;
+        std::uintmax_t size = std::filesystem::file_size(path, error);
+        if (!error && std::filesystem::remove(path, error)) {
+            std::lock_guard<std::mutex> guard(lock);
+            used = used > size ? used - size : 0;
+        }
+        return false;
+    }
+
+    static bool read(std::ifstream& in, std::int32_t* values, int count) {
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(values), std::streamsize(count) * sizeof(std::int32_t)));
+    }
+
+    // Total size of the entries, listing them oldest first when asked
+    std::uintmax_t scan(std::vector<std::pair<std::filesystem::file_time_type, std::filesystem::path>>* entries) const {
+        std::uintmax_t total = 0;
+        std::error_code error;
+        for (const auto& entry : std::filesystem::directory_iterator(dir, error)) {
+            if (entry.path().extension() != ".bin") continue;
+            std::error_code entryError;
+            std::uintmax_t size = entry.file_size(entryError);
+            if (entryError) continue;
+            total += size;
+            if (entries) entries->push_back({entry.last_write_time(entryError), entry.path()});
+        }
+        if (entries) std::sort(entries->begin(), entries->end());
+        return total;
+    }
+
+    // Removes least recently used entries until the cache is back within budget; called with the lock held
+    void evict() {
+        std::vector<std::pair<std::filesystem::file_time_type, std::filesystem::path>> entries;
+        used = scan(&entries);
+        for (const auto& entry : entries) {
+            if (used <= budget) break;
+            std::error_code error;
+            std::uintmax_t size = std::filesystem::file_size(entry.second, error);
+            if (!error && std::filesystem::remove(entry.second, error)) used -= size;
+        }
+    }
+
+    std::filesystem::path dir;
+    std::uintmax_t budget;
+    bool usable = false;
+    std::mutex lock;
+    std::uintmax_t used = 0; // Bytes in entries, as far as this process knows; guarded by lock
+};
+
+#endif
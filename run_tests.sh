@@ -0,0 +1,104 @@
+#!/bin/sh
+# Runs every testcase through the CLI. Each NN-input.txt must print NN-output.txt, blank lines aside: the older
+# fixtures separate stats blocks that the binary prints back to back. An NN-replay.txt holds --replay arguments for a
+# log recorded from the input, with the expected output in NN-replay-output.txt. Every input must also print the same
+# with --parallel, which splits runs at idle gaps, and so must a generated workload big enough for the FCFS scan to
+# cut into several blocks. Runs from the result cache must print what the engine prints, also once its entries have
+# been corrupted.
+# Exits non-zero when anything differs.
+
+BIN=./CPU-Scheduling-Simulation
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+failures=0
+
+fail() {
+    echo "FAIL: $*"
+    failures=$((failures + 1))
+}
+
+# The file without blank lines
+trimmed() {
+    awk 'length($0) > 0' "$1"
+}
+
+same() {
+    trimmed "$1" > "$TMP/a"
+    trimmed "$2" > "$TMP/b"
+    cmp -s "$TMP/a" "$TMP/b"
+}
+
+for input in testcases/*-input.txt; do
+    case=${input%-input.txt}
+    name=${case#testcases/}
+
+    "$BIN" < "$input" > "$TMP/plain.txt" 2>&1
+    same "$TMP/plain.txt" "$case-output.txt" || fail "$name: output differs from $case-output.txt"
+
+    if [ -f "$case-replay.txt" ]; then
+        "$BIN" --record "$TMP/log" < "$input" 2> /dev/null
+        # shellcheck disable=SC2046
+        "$BIN" --replay "$TMP/log" $(cat "$case-replay.txt") > "$TMP/replay.txt" 2>&1
+        same "$TMP/replay.txt" "$case-replay-output.txt" || fail "$name: replay differs from $case-replay-output.txt"
+        "$BIN" --replay "$TMP/log" > "$TMP/replay.txt" 2>&1
+        cmp -s "$TMP/replay.txt" "$TMP/plain.txt" || fail "$name: full replay differs from the plain run"
+    fi
+
+    for workers in 1 4; do
+        "$BIN" --parallel --workers "$workers" < "$input" > "$TMP/parallel.txt" 2>&1
+        cmp -s "$TMP/parallel.txt" "$TMP/plain.txt" || fail "$name: --parallel --workers $workers differs from the plain run"
+    done
+done
+
+# 140000 processes in busy periods of 4999 separated by idle gaps, so the scan blocks start inside busy periods. The
+# processes of a period arrive every 2 ticks and need 3 on average, and the next period starts once this one is done.
+awk -v n=140000 'BEGIN {
+    for (i = 0; i < n; ++i) {
+        if (i % 4999 == 0) {
+            start += work + 100
+            work = 0
+        }
+        service = 1 + (i * 13) % 5
+        line[i] = "P" i "," start + 2 * (i % 4999) "," service
+        work += service
+    }
+    print "stats"; print "1,2-3,3"; print start + work + 10000; print n
+    for (i = 0; i < n; ++i) print line[i]
+}' > "$TMP/busy.txt"
+"$BIN" < "$TMP/busy.txt" > "$TMP/plain.txt" 2>&1
+for workers in 1 4; do
+    "$BIN" --parallel --workers "$workers" < "$TMP/busy.txt" > "$TMP/parallel.txt" 2>&1
+    cmp -s "$TMP/parallel.txt" "$TMP/plain.txt" || fail "busy periods: --parallel --workers $workers differs from the plain run"
+done
+
+# The cache: the second run of each input prints stored results, a stats run can use the entries of a trace run
+cache="$TMP/cache"
+for pass in 1 2; do
+    for case in testcases/23a testcases/23b; do
+        "$BIN" --cache --cache-dir "$cache" < "$case-input.txt" > "$TMP/cached.txt" 2>&1
+        same "$TMP/cached.txt" "$case-output.txt" || fail "${case#testcases/}: cached run $pass differs from $case-output.txt"
+    done
+done
+
+# Truncated entries and entries with finish times past the schedule must be dropped and run by the engine again
+cp -r "$cache" "$TMP/stored"
+corrupt=0
+for entry in "$cache"/*.bin; do
+    if [ $((corrupt % 2)) -eq 0 ]; then
+        head -c 20 "$entry" > "$TMP/entry" && mv "$TMP/entry" "$entry"
+    else
+        printf 'garbage!' | dd of="$entry" bs=1 seek=16 conv=notrunc 2> /dev/null
+    fi
+    corrupt=$((corrupt + 1))
+done
+"$BIN" --cache --cache-dir "$cache" < testcases/23a-input.txt > "$TMP/cached.txt" 2>&1
+same "$TMP/cached.txt" testcases/23a-output.txt || fail "23a: run over corrupted cache entries differs from the output"
+for entry in "$TMP/stored"/*.bin; do
+    cmp -s "$entry" "$cache/${entry##*/}" || fail "cache: corrupted entry ${entry##*/} was not stored again"
+done
+
+if [ "$failures" -gt 0 ]; then
+    echo "$failures failed"
+    exit 1
+fi
+echo "All testcases passed"
@@ -0,0 +1,100 @@
+#include "sched_api.h"
+#include "scheduler.h"
+
+#include <new>
+
+struct sched_context {
+    arena mem;
+    workload w;
+    std::vector<process_stats> stats;
+
+    explicit sched_context(bool huge_pages) : mem(0, huge_pages) {}
+};
+
+namespace {
+
+// Records finish times and writes coalesced slices into the caller's array, counting the ones that do not fit
+struct result_output {
+    std::vector<process_stats>& stats;
+    sched_result& result;
+    sched_slice pending{IDLE, 0, 0};
+    int now = 0;
+
+    void emit(int id, int count) {
+        if (count <= 0) return;
+        if (id != IDLE) stats[id].finish_time = now + count;
+        if (pending.length > 0 && pending.process == id) {
+            pending.length += count;
+        } else {
+            flush();
+            pending = {id, now, count};
+        }
+        now += count;
+    }
+
+    void flush() {
+        if (pending.length == 0) return;
+        if (result.slices && result.slice_count < result.slice_capacity) {
+            result.slices[result.slice_count] = pending;
+        }
+        result.slice_count++;
+        pending.length = 0;
+    }
+};
+
+} // namespace
+
+extern "C" {
+
+sched_context* sched_create(int huge_pages) {
+    return new (std::nothrow) sched_context(huge_pages != 0);
+}
+
+void sched_destroy(sched_context* ctx) {
+    delete ctx;
+}
+
+int sched_run(sched_context* ctx, const int* arrival, const int* service, size_t n, sched_algorithm algo,
+              int last_instant, sched_result* result) {
+    if (!ctx || !result || !result->finish || n > (size_t)INT_MAX || (n > 0 && (!arrival || !service))) {
+        return SCHED_INVALID_ARGUMENT;
+    }
+    int total_time = last_instant > 0 ? last_instant : UNTIL_DRAINED;
+    if (algo.id == 8 && total_time == UNTIL_DRAINED) return SCHED_INVALID_ARGUMENT;
+    if ((algo.id == 2 || algo.id == 8) && algo.quantum <= 0) return SCHED_INVALID_ARGUMENT;
+
+    result->slice_count = 0;
+    try {
+        workload& w = ctx->w;
+        buildWorkload(w, arrival, service, (int)n);
+        ctx->stats.assign(n, process_stats());
+        ctx->mem.reserve(arenaBytes(n, timelineBound(w, last_instant)));
+
+        algorithm descriptor;
+        descriptor.algorithm_id = algo.id;
+        descriptor.quantum = algo.quantum;
+        descriptor.seed = algo.seed;
+        bool known;
+        {
+            result_output output{ctx->stats, *result};
+            known = run_workload(descriptor, w, output, ctx->mem, total_time);
+            output.flush();
+        }
+        ctx->mem.reset();
+        if (!known) return SCHED_INVALID_ALGORITHM;
+
+        completeStats(w, ctx->stats);
+        for (size_t id = 0; id < n; ++id) {
+            const process_stats& s = ctx->stats[id];
+            result->finish[id] = s.finish_time;
+            if (result->turnaround) result->turnaround[id] = s.turnaround_time;
+            if (result->norm_turnaround) result->norm_turnaround[id] = s.norm_turnaround_time;
+        }
+    } catch (const std::bad_alloc&) {
+        ctx->mem.reset();
+        return SCHED_OUT_OF_MEMORY;
+    }
+    return result->slices && result->slice_count > result->slice_capacity ? SCHED_SLICES_TRUNCATED : SCHED_OK;
+}
+
+} // extern "C"
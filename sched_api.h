@@ -0,0 +1,66 @@
+#ifndef SCHED_API_H
+#define SCHED_API_H
+
+#include <stddef.h>
+
+//------------------------------------------------------------------------------------------------------------------------//
+//C API
+// Runs one scheduling algorithm over caller-owned arrival/service arrays and writes the results into caller-owned
+// arrays. There is no parsing, printing or string handling; process i is element i of the input arrays. A context
+// keeps its memory between runs, so repeated runs of similar size do not allocate. A context is not thread safe;
+// use one per thread.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Algorithm ids as in the input format: 1 FCFS, 2 RR, 3 SPN, 4 SRT, 5 HRRN, 6 FB-1, 7 FB-2i, 8 Aging, 9 Lottery,
+// 10 Stride, 11 EDF, 12 CFS, 14 HFS. quantum is used by RR, Aging, Lottery, Stride and HFS, and is the target latency
+// of CFS; seed only by Lottery. Every process holds one ticket, has no deadline and sits in the root group. 13 MLQ
+// needs per-class policies, which this interface cannot express, so it reports SCHED_INVALID_ALGORITHM.
+typedef struct {
+    int id;
+    int quantum;
+    unsigned long seed;
+} sched_algorithm;
+
+// A run of consecutive ticks given to one process; process is -1 while the CPU is idle
+typedef struct {
+    int process;
+    int start;
+    int length;
+} sched_slice;
+
+typedef struct {
+    int* finish;            // n entries; 0 for a process that never ran
+    int* turnaround;        // n entries, or NULL
+    float* norm_turnaround; // n entries, or NULL
+    sched_slice* slices;    // slice_capacity entries, or NULL; adjacent ticks of one process are merged
+    size_t slice_capacity;
+    size_t slice_count;     // set by sched_run: slices in the whole schedule, even past slice_capacity
+} sched_result;
+
+enum {
+    SCHED_OK = 0,
+    SCHED_SLICES_TRUNCATED = 1, // results are complete but only slice_capacity slices were written
+    SCHED_INVALID_ALGORITHM = -1,
+    SCHED_INVALID_ARGUMENT = -2,
+    SCHED_OUT_OF_MEMORY = -3
+};
+
+typedef struct sched_context sched_context;
+
+// huge_pages backs the context's arena with transparent huge pages (Linux)
+sched_context* sched_create(int huge_pages);
+void sched_destroy(sched_context* ctx);
+
+// Preemptive algorithms run until last_instant; last_instant <= 0 runs until every process has finished, which
+// Aging never does, so it needs a positive last_instant. Returns one of the SCHED_ codes above.
+int sched_run(sched_context* ctx, const int* arrival, const int* service, size_t n, sched_algorithm algo,
+              int last_instant, sched_result* result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
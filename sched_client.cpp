@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Client for the --serve mode, doubling as a throughput benchmark.
+// usage: sched_client SOCKET INPUT [requests] [concurrency]
+// With one request the response is printed; otherwise the requests are spread over `concurrency` connections at a
+// time and throughput plus latency are reported.
+
+static bool request(const char* path, const std::string& input, std::string& response) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return false;
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        close(fd);
+        return false;
+    }
+
+    size_t sent = 0;
+    while (sent < input.size()) {
+        ssize_t put = write(fd, input.data() + sent, input.size() - sent);
+        if (put <= 0) {
+            close(fd);
+            return false;
+        }
+        sent += put;
+    }
+    shutdown(fd, SHUT_WR);
+
+    response.clear();
+    char buffer[1 << 16];
+    ssize_t got;
+    while ((got = read(fd, buffer, sizeof(buffer))) > 0) {
+        response.append(buffer, got);
+    }
+    close(fd);
+    return got == 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::fprintf(stderr, "usage: %s SOCKET INPUT [requests] [concurrency]\n", argv[0]);
+        return 1;
+    }
+    const char* path = argv[1];
+    int requests = argc > 3 ? std::max(1, std::atoi(argv[3])) : 1;
+    int concurrency = argc > 4 ? std::max(1, std::atoi(argv[4])) : 1;
+
+    std::ifstream file(argv[2]);
+    if (!file) {
+        std::perror(argv[2]);
+        return 1;
+    }
+    std::stringstream contents;
+    contents << file.rdbuf();
+    std::string input = contents.str();
+
+    if (requests == 1) {
+        std::string response;
+        if (!request(path, input, response)) {
+            std::perror(path);
+            return 1;
+        }
+        std::fwrite(response.data(), 1, response.size(), stdout);
+        return 0;
+    }
+
+    // Every response must match the first one
+    std::string expected;
+    if (!request(path, input, expected)) {
+        std::perror(path);
+        return 1;
+    }
+
+    std::vector<std::vector<double>> latencies(concurrency);
+    std::vector<int> failures(concurrency, 0);
+    std::vector<std::thread> clients;
+    auto start = std::chrono::steady_clock::now();
+    for (int c = 0; c < concurrency; ++c) {
+        int share = requests / concurrency + (c < requests % concurrency ? 1 : 0);
+        clients.emplace_back([&, c, share]() {
+            std::string response;
+            for (int i = 0; i < share; ++i) {
+                auto sentAt = std::chrono::steady_clock::now();
+                if (!request(path, input, response) || response != expected) failures[c]++;
+                latencies[c].push_back(
+                    std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - sentAt).count());
+            }
+        });
+    }
+    for (auto& client : clients) {
+        client.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<double> all;
+    int failed = 0;
+    for (int c = 0; c < concurrency; ++c) {
+        all.insert(all.end(), latencies[c].begin(), latencies[c].end());
+        failed += failures[c];
+    }
+    std::sort(all.begin(), all.end());
+    double sum = 0.0;
+    for (double l : all) sum += l;
+
+    std::printf("%d requests, %d concurrent, %.2f s: %.0f requests/s\n", requests, concurrency, seconds,
+                requests / seconds);
+    std::printf("latency us: mean %.1f p50 %.1f p99 %.1f max %.1f\n", sum / all.size(), all[all.size() / 2],
+                all[std::min(all.size() - 1, all.size() * 99 / 100)], all.back());
+    if (failed) {
+        std::printf("%d requests failed or returned a different response\n", failed);
+        return 1;
+    }
+    return 0;
+}
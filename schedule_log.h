@@ -0,0 +1,410 @@
+#ifndef SCHEDULE_LOG_H
+#define SCHEDULE_LOG_H
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "scheduler.h"
+
+//------------------------------------------------------------------------------------------------------------------------//
+//Schedule log
+// A compact archive of finished schedules that can be rendered again without running the engines. The file starts
+// with the operation, lastInstant and the process table. One section per algorithm follows: each slice is a record
+// of three varints (process id, ticks since the previous slice ended, length), and idle time only shows up in the
+// gaps. A slice that completes a CPU burst with I/O after it is followed by a two-varint record (n + process id, I/O
+// length) for the wait, which starts where that slice ends. Every SEEK_STRIDE slices the writer notes the time and
+// file offset, and the footer holds these seek points together with each process's finish time, so a reader can
+// start decoding near any time instead of at the start.
+//
+//   header   magic, version, operation, lastInstant, n, then the columns arrival[n], service[n], tickets[n],
+//            deadline[n], ids by arrival[n], name offsets[n + 1] and the names
+//   sections the record streams, back to back
+//   footer   section count, then per section name, records [begin, end) (8 bytes each), length, longest I/O wait,
+//            finish[n], ids by finish[n], seek point count, seek points (time, offset of 8 bytes)
+//   trailer  footer offset (8 bytes), magic
+//
+// Fields are little-endian 32-bit integers unless noted. Every table has a fixed width, so a reader maps the file and
+// binary searches it in place; opening a log reads nothing that grows with the process count or the schedule.
+
+class schedule_log_writer {
+public:
+    static const std::uint32_t MAGIC = 0x31474c53; // "SLG1"
+    static const int VERSION = 2;
+    static const int SEEK_STRIDE = 1024;
+
+    schedule_log_writer(std::ostream& out, const workload& w, const std::string& operation, int lastInstant)
+        : out(out), w(w), n(w.size()), executed(n, 0), next_burst(n, 0) {
+        word(MAGIC);
+        word(VERSION);
+        text(operation);
+        word(lastInstant);
+        word(n);
+        for (const std::vector<int>* column : {&w.arrival, &w.service, &w.tickets, &w.deadlines, &w.by_arrival}) {
+            for (int value : *column) {
+                word(value);
+            }
+        }
+        std::uint32_t nameOffset = 0;
+        word(nameOffset);
+        for (int id = 0; id < n; ++id) {
+            nameOffset += nameOf(id).size();
+            word(nameOffset);
+        }
+        for (int id = 0; id < n; ++id) {
+            std::string name = nameOf(id);
+            bytes(name.data(), name.size());
+        }
+    }
+
+    schedule_log_writer(const schedule_log_writer&) = delete;
+    schedule_log_writer& operator=(const schedule_log_writer&) = delete;
+
+    // Starts an algorithm's section; without bursts (Aging) no I/O waits are logged
+    void begin(const std::string& name, bool bursts) {
+        sections.push_back(section{name, offset, offset, 0, 0, std::vector<int>(n, 0), {}});
+        tracksBursts = bursts && w.has_io();
+        std::fill(executed.begin(), executed.end(), 0);
+        std::fill(next_burst.begin(), next_burst.end(), 0);
+        recordEnd = 0;
+        records = 0;
+    }
+
+    // Slices arrive in time order, starting where the previous one ended
+    void record(int id, int start, int length) {
+        section& s = sections.back();
+        if (records++ % SEEK_STRIDE == 0) s.seek.push_back({recordEnd, offset});
+        varint(id);
+        varint(start - recordEnd);
+        varint(length);
+        recordEnd = start + length;
+        s.finish[id] = recordEnd;
+
+        // The I/O after a completed CPU burst starts where the slice ends
+        for (int left = length; tracksBursts && left > 0;) {
+            int b = w.burst_start[id] + next_burst[id];
+            if (b >= w.burst_start[id + 1]) break;
+            int run = std::min(left, w.bursts[b] - executed[id]);
+            executed[id] += run;
+            left -= run;
+            if (executed[id] < w.bursts[b]) break;
+            executed[id] = 0;
+            next_burst[id] += 2;
+            if (b + 1 < w.burst_start[id + 1] && w.bursts[b + 1] > 0) {
+                varint(n + id);
+                varint(w.bursts[b + 1]);
+                s.longest_wait = std::max(s.longest_wait, w.bursts[b + 1]);
+            }
+        }
+    }
+
+    void end(int length) {
+        sections.back().end = offset;
+        sections.back().length = length;
+    }
+
+    void finish() {
+        long long footer = offset;
+        word(sections.size());
+        for (const section& s : sections) {
+            text(s.name);
+            wide(s.begin);
+            wide(s.end);
+            word(s.length);
+            word(s.longest_wait);
+            for (int f : s.finish) {
+                word(f);
+            }
+            std::vector<int> byFinish(n);
+            for (int id = 0; id < n; ++id) {
+                byFinish[id] = id;
+            }
+            std::stable_sort(byFinish.begin(), byFinish.end(), [&](int a, int b) { return s.finish[a] < s.finish[b]; });
+            for (int id : byFinish) {
+                word(id);
+            }
+            word(s.seek.size());
+            for (const auto& point : s.seek) {
+                word(point.first);
+                wide(point.second);
+            }
+        }
+        wide(footer);
+        word(MAGIC);
+        out.flush();
+    }
+
+private:
+    struct section {
+        std::string name;
+        long long begin;
+        long long end;
+        int length;
+        int longest_wait;
+        std::vector<int> finish;                     // End of each process's last slice, 0 when it never ran
+        std::vector<std::pair<int, long long>> seek; // (time the previous slice ended, offset of the record)
+    };
+
+    // The C API has no names
+    std::string nameOf(int id) const { return id < (int)w.names.size() ? w.names[id] : "P" + std::to_string(id); }
+
+    void bytes(const void* data, size_t count) {
+        out.write(static_cast<const char*>(data), count);
+        offset += count;
+    }
+    void word(std::uint32_t value) {
+        unsigned char b[4] = {(unsigned char)value, (unsigned char)(value >> 8), (unsigned char)(value >> 16),
+                              (unsigned char)(value >> 24)};
+        bytes(b, 4);
+    }
+    void wide(long long value) {
+        word((std::uint32_t)value);
+        word((std::uint32_t)((unsigned long long)value >> 32));
+    }
+    void text(const std::string& s) {
+        word(s.size());
+        bytes(s.data(), s.size());
+    }
+    void varint(std::uint32_t value) {
+        unsigned char b[5];
+        int k = 0;
+        while (value >= 0x80) {
+            b[k++] = (unsigned char)(value | 0x80);
+            value >>= 7;
+        }
+        b[k++] = (unsigned char)value;
+        bytes(b, k);
+    }
+
+    std::ostream& out;
+    const workload& w;
+    int n;
+    long long offset = 0;
+    std::vector<section> sections;
+    bool tracksBursts = false;
+    std::vector<int> executed;   // Ticks run in the current CPU burst
+    std::vector<int> next_burst; // Position in the burst list of the current CPU burst
+    int recordEnd = 0;
+    long long records = 0;
+};
+
+// Sink that logs one algorithm's schedule
+struct schedule_log_output {
+    schedule_log_writer& log;
+    int now = 0;
+
+    void emit(int id, int count) {
+        if (count <= 0) return;
+        if (id != IDLE) log.record(id, now, count);
+        now += count;
+    }
+};
+
+// Read-only view of a log, mapped into memory. Opening it checks that every table lies inside the file; the values
+// read out of the tables are checked where they are used, and a value out of range makes that call fail.
+class schedule_log_reader {
+public:
+    struct section {
+        std::string name;
+        long long begin;
+        long long end;
+        int length;
+        int longest_wait;
+        size_t finish;    // Offset of n words
+        size_t by_finish; // Offset of n words
+        int seek_points;
+        size_t seek;      // Offset of the (time word, offset 8 bytes) pairs
+    };
+
+    std::string operation;
+    int last_instant = 0;
+    int n = 0;
+    std::vector<section> sections;
+
+    schedule_log_reader() = default;
+    ~schedule_log_reader() {
+        if (data) munmap(const_cast<unsigned char*>(data), size);
+    }
+    schedule_log_reader(const schedule_log_reader&) = delete;
+    schedule_log_reader& operator=(const schedule_log_reader&) = delete;
+
+    // False when the file cannot be mapped or its tables do not fit in it
+    bool open(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size < 12) {
+            close(fd);
+            return false;
+        }
+        size = info.st_size;
+        void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED) return false;
+        data = static_cast<const unsigned char*>(p);
+
+        if (word(size - 4) != schedule_log_writer::MAGIC) return false;
+        size_t at = 0;
+        if (!take(at, 8) || word(0) != schedule_log_writer::MAGIC || word(4) != schedule_log_writer::VERSION) {
+            return false;
+        }
+        if (!text(at, operation) || !number(at, last_instant) || !number(at, n) || n < 0) return false;
+        columns = at;
+        if (!take(at, 5 * 4 * (size_t)n)) return false;
+        name_offsets = at;
+        if (!take(at, 4 * ((size_t)n + 1))) return false;
+        names = at;
+        if (!take(at, word(name_offsets + 4 * (size_t)n))) return false;
+        size_t records = at;
+
+        size_t footer = wide(size - 12);
+        if (footer < records || footer > size - 12) return false;
+        at = footer;
+        int count;
+        if (!number(at, count) || count < 0) return false;
+        sections.resize(count);
+        for (section& s : sections) {
+            if (!text(at, s.name) || !take(at, 24)) return false;
+            s.begin = wide(at - 24);
+            s.end = wide(at - 16);
+            s.length = word(at - 8);
+            s.longest_wait = word(at - 4);
+            s.finish = at;
+            s.by_finish = at + 4 * (size_t)n;
+            if (!take(at, 8 * (size_t)n) || !number(at, s.seek_points) || s.seek_points < 0) return false;
+            s.seek = at;
+            if (!take(at, 12 * (size_t)s.seek_points)) return false;
+            if (s.begin < (long long)records || s.begin > s.end || s.end > (long long)footer) return false;
+            if (s.length < 0 || s.longest_wait < 0) return false;
+        }
+        return true;
+    }
+
+    // Per-process columns; id must be in [0, n)
+    int arrival(int id) const { return column(0, id); }
+    int service(int id) const { return column(1, id); }
+    int tickets(int id) const { return column(2, id); }
+    int deadline(int id) const { return column(3, id); }
+
+    // The process at a position in arrival order, or -1 when the table is corrupt
+    int by_arrival(int k) const { return checkedId(column(4, k)); }
+
+    // False when the name table is corrupt
+    bool name(int id, std::string& value) const {
+        std::uint32_t first = word(name_offsets + 4 * (size_t)id);
+        std::uint32_t last = word(name_offsets + 4 * ((size_t)id + 1));
+        std::uint32_t total = word(name_offsets + 4 * (size_t)n);
+        if (first > last || last > total) return false;
+        value.assign(reinterpret_cast<const char*>(data + names + first), last - first);
+        return true;
+    }
+
+    // A process as it was given, except for its bursts; false when the log is corrupt
+    bool process_at(int id, process& proc) const {
+        if (!name(id, proc.name)) return false;
+        proc.arrival_time = arrival(id);
+        proc.service_time = service(id);
+        proc.tickets = tickets(id);
+        proc.deadline = deadline(id);
+        return proc.service_time >= 0 && proc.tickets > 0;
+    }
+
+    // Finish time of a process in a section, or -1 when it is not a time within the schedule
+    int finish(const section& s, int id) const {
+        int f = word(s.finish + 4 * (size_t)id);
+        return f >= 0 && f <= s.length ? f : -1;
+    }
+    // The process at a position in finish order, or -1 when the table is corrupt
+    int by_finish(const section& s, int k) const { return checkedId(word(s.by_finish + 4 * (size_t)k)); }
+
+    // Calls visit(process, start, length, blocked) for every slice, and every I/O wait when blocked is true, that
+    // overlaps [from, to), in the order they were logged. Decoding starts at the last seek point at or before the
+    // longest I/O wait ahead of `from`, so the cost follows the range, not the schedule. False when a record does not
+    // decode to a process of the log or runs past the schedule.
+    template <class Visit>
+    bool slices(const section& s, int from, int to, Visit visit) const {
+        if (s.seek_points == 0) return true;
+        int target = std::max(0, from - s.longest_wait);
+        int lo = 0, hi = s.seek_points;
+        while (hi - lo > 1) {
+            int mid = (lo + hi) / 2;
+            if (seekTime(s, mid) <= target) lo = mid;
+            else hi = mid;
+        }
+        long long position = wide(seekEntry(s, lo) + 4);
+        if (position < s.begin || position > s.end) return false;
+        const unsigned char* p = data + position;
+        const unsigned char* end = data + s.end;
+        long long recordEnd = seekTime(s, lo);
+        while (p < end) {
+            std::uint32_t id, gap, length;
+            if (!varint(p, end, id) || id >= 2 * (std::uint32_t)n) return false;
+            if (id >= (std::uint32_t)n) {
+                if (!varint(p, end, length) || recordEnd + length > INT_MAX) return false;
+                if (recordEnd >= to) return true;
+                if (recordEnd + length > from) visit(int(id - n), int(recordEnd), int(length), true);
+                continue;
+            }
+            if (!varint(p, end, gap) || !varint(p, end, length)) return false;
+            long long start = recordEnd + gap;
+            if (start >= to) return true;
+            recordEnd = start + length;
+            if (recordEnd > s.length) return false;
+            if (recordEnd > from) visit(int(id), int(start), int(length), false);
+        }
+        return true;
+    }
+
+private:
+    int column(int c, int id) const { return word(columns + 4 * ((size_t)c * n + id)); }
+    int checkedId(std::uint32_t id) const { return id < (std::uint32_t)n ? int(id) : -1; }
+    int seekTime(const section& s, int k) const { return word(seekEntry(s, k)); }
+    size_t seekEntry(const section& s, int k) const { return s.seek + 12 * (size_t)k; }
+
+    std::uint32_t word(size_t at) const {
+        return data[at] | data[at + 1] << 8 | data[at + 2] << 16 | (std::uint32_t)data[at + 3] << 24;
+    }
+    long long wide(size_t at) const { return (long long)(word(at) | (std::uint64_t)word(at + 4) << 32); }
+
+    // Advances past `count` bytes if the file has them
+    bool take(size_t& at, size_t count) const {
+        if (count > size - at) return false;
+        at += count;
+        return true;
+    }
+    bool number(size_t& at, int& value) const {
+        if (!take(at, 4)) return false;
+        value = word(at - 4);
+        return true;
+    }
+    bool text(size_t& at, std::string& value) const {
+        int length;
+        if (!number(at, length) || length < 0 || !take(at, length)) return false;
+        value.assign(reinterpret_cast<const char*>(data + at - length), length);
+        return true;
+    }
+    static bool varint(const unsigned char*& p, const unsigned char* end, std::uint32_t& value) {
+        value = 0;
+        for (int shift = 0; p < end && shift < 35; shift += 7) {
+            unsigned char b = *p++;
+            value |= std::uint32_t(b & 0x7f) << shift;
+            if (!(b & 0x80)) return true;
+        }
+        return false;
+    }
+
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+    size_t columns = 0;      // Offset of the five process columns
+    size_t name_offsets = 0; // Offset of the n + 1 name offsets
+    size_t names = 0;        // Offset of the name characters
+};
+
+#endif
@@ -0,0 +1,239 @@
+#include "scheduler.h"
+#include <cstdlib>
+
+// Adds a process as the next one in arrival order and returns its id
+int appendProcess(workload& w, const process& proc) {
+    int id = w.size();
+    w.names.push_back(proc.name);
+    w.arrival.push_back(proc.arrival_time);
+    w.service.push_back(proc.service_time);
+    w.by_arrival.push_back(id);
+    w.sorted_arrival.push_back(proc.arrival_time);
+    w.sorted_service.push_back(proc.service_time);
+    w.tickets.push_back(proc.tickets);
+    w.deadlines.push_back(proc.deadline);
+    w.class_ids.push_back(proc.class_id);
+    w.group_ids.push_back(internGroup(w, proc.group));
+    if (w.burst_start.empty()) w.burst_start.push_back(0);
+    w.bursts.insert(w.bursts.end(), proc.bursts.begin(), proc.bursts.end());
+    w.burst_start.push_back(w.bursts.size());
+    return id;
+}
+
+int internGroup(workload& w, const std::string& path) {
+    if (w.group_parent.empty()) {
+        w.group_parent.push_back(-1);
+        w.group_weight.push_back(1);
+    }
+    int group = 0;
+    std::string key;
+    for (size_t start = 0; start < path.size();) {
+        size_t end = std::min(path.find('/', start), path.size());
+        size_t colon = path.find(':', start);
+        size_t nameEnd = colon < end ? colon : end;
+        if (!key.empty()) key += '/';
+        key.append(path, start, nameEnd - start);
+
+        auto found = w.group_index.find(key);
+        if (found == w.group_index.end()) {
+            found = w.group_index.emplace(key, w.group_parent.size()).first;
+            w.group_parent.push_back(group);
+            w.group_weight.push_back(1);
+        }
+        group = found->second;
+        if (colon < end) w.group_weight[group] = std::max(1, std::atoi(path.c_str() + colon + 1));
+        start = end + 1;
+    }
+    return group;
+}
+
+// Orders by_arrival and the sorted_* copies; the sort is stable so equal arrivals keep input order
+static void sortByArrival(workload& w) {
+    int n = w.size();
+    std::stable_sort(w.by_arrival.begin(), w.by_arrival.end(), [&w](int a, int b) {
+        return w.arrival[a] < w.arrival[b];
+    });
+    for (int i = 0; i < n; ++i) {
+        w.sorted_arrival[i] = w.arrival[w.by_arrival[i]];
+        w.sorted_service[i] = w.service[w.by_arrival[i]];
+    }
+}
+
+workload buildWorkload(const std::vector<process>& processes) {
+    workload w;
+    for (const auto& p : processes) {
+        appendProcess(w, p);
+    }
+
+    sortByArrival(w);
+    return w;
+}
+
+void buildWorkload(workload& w, const int* arrival, const int* service, int n) {
+    w.names.clear();
+    w.arrival.assign(arrival, arrival + n);
+    w.service.assign(service, service + n);
+    w.by_arrival.resize(n);
+    w.sorted_arrival.resize(n);
+    w.sorted_service.resize(n);
+    w.burst_start.assign(n + 1, 0);
+    w.bursts.clear();
+    w.tickets.assign(n, 1);
+    w.deadlines.assign(n, NO_DEADLINE);
+    w.class_ids.assign(n, 0);
+    w.group_ids.assign(n, 0);
+    w.group_parent.assign(1, -1);
+    w.group_weight.assign(1, 1);
+    w.group_index.clear();
+    for (int id = 0; id < n; ++id) {
+        w.by_arrival[id] = id;
+    }
+    sortByArrival(w);
+}
+
+// Fills in turnaround and normalized turnaround once every finish time is known
+void completeStats(const workload& w, std::vector<process_stats>& stats) {
+    for (int id = 0; id < w.size(); ++id) {
+        process_stats& s = stats[id];
+        if (s.finish_time == 0) continue;
+        s.turnaround_time = s.finish_time - w.arrival[id];
+        s.norm_turnaround_time = static_cast<float>(s.turnaround_time) / w.service[id];
+    }
+}
+
+void calculateStatsFromOutput(const workload& w, const timeline& output, std::vector<process_stats>& stats) {
+    stats.assign(w.size(), process_stats());
+
+    // A process finishes one tick after its last occurrence in the output
+    for (int i = 0; i < (int)output.size(); ++i) {
+        if (output[i] != IDLE) {
+            stats[output[i]].finish_time = i + 1;
+        }
+    }
+    completeStats(w, stats);
+}
+
+// A process is entitled to tickets/T(t) of every tick it spends in the system, where T(t) is the ticket total of
+// everything in the system at t. One sweep over the arrival and finish events builds the running integral of
+// 1/T(t), so the whole report is O(n log n) however long the run was.
+std::vector<double> targetShares(const workload& w, const std::vector<process_stats>& stats) {
+    std::vector<std::pair<int, long long>> events; // (time, change in ticket total)
+    for (int id = 0; id < w.size(); ++id) {
+        if (stats[id].finish_time == 0) continue;
+        events.push_back({w.arrival[id], w.tickets[id]});
+        events.push_back({stats[id].finish_time, -w.tickets[id]});
+    }
+    std::sort(events.begin(), events.end());
+
+    // integral[k] is the integral of 1/T(t) from the first event up to times[k]
+    std::vector<int> times;
+    std::vector<double> integral;
+    long long total = 0;
+    for (size_t e = 0; e < events.size();) {
+        int now = events[e].first;
+        if (!times.empty()) {
+            double span = static_cast<double>(now) - times.back();
+            integral.push_back(integral.back() + (total > 0 ? span / total : 0.0));
+        } else {
+            integral.push_back(0.0);
+        }
+        times.push_back(now);
+        for (; e < events.size() && events[e].first == now; ++e) total += events[e].second;
+    }
+
+    auto at = [&](int time) {
+        return integral[std::lower_bound(times.begin(), times.end(), time) - times.begin()];
+    };
+    std::vector<double> shares(w.size(), 0.0);
+    for (int id = 0; id < w.size(); ++id) {
+        const process_stats& s = stats[id];
+        if (s.finish_time == 0 || s.turnaround_time == 0) continue;
+        shares[id] = w.tickets[id] * (at(s.finish_time) - at(w.arrival[id])) / s.turnaround_time;
+    }
+    return shares;
+}
+
+// Percentiles come from nth_element on the lateness values, so the report is linear in the number of processes
+deadline_report deadlineReport(const workload& w, const std::vector<process_stats>& stats) {
+    deadline_report report;
+    std::vector<int> lateness;
+    long long busy = 0;
+    int first = INT_MAX, last = 0;
+    for (int id = 0; id < w.size(); ++id) {
+        const process_stats& s = stats[id];
+        if (s.finish_time == 0) continue;
+        busy += w.service[id];
+        first = std::min(first, w.arrival[id]);
+        last = std::max(last, s.finish_time);
+        if (w.deadlines[id] == NO_DEADLINE) continue;
+        lateness.push_back(s.finish_time - w.deadlines[id]);
+        if (s.finish_time > w.deadlines[id]) report.missed++;
+    }
+    if (last > first) report.utilization = static_cast<double>(busy) / (static_cast<long long>(last) - first);
+
+    report.with_deadline = lateness.size();
+    if (lateness.empty()) return report;
+    auto percentile = [&lateness](int p) {
+        auto nth = lateness.begin() + (lateness.size() - 1) * p / 100;
+        std::nth_element(lateness.begin(), nth, lateness.end());
+        return *nth;
+    };
+    report.p50 = percentile(50);
+    report.p90 = percentile(90);
+    report.p99 = percentile(99);
+    report.max = *std::max_element(lateness.begin(), lateness.end());
+    return report;
+}
+
+// One pass in arrival order: a process that arrives once all earlier work is done starts a new busy period
+std::vector<int> idleBoundaries(const workload& w, long long& lastEnd) {
+    std::vector<int> starts;
+    long long busyEnd = 0;
+    for (int pos = 0; pos < w.size(); ++pos) {
+        if (pos == 0 || w.sorted_arrival[pos] >= busyEnd) starts.push_back(pos);
+        busyEnd = std::max<long long>(busyEnd, w.sorted_arrival[pos]) + w.sorted_service[pos];
+    }
+    lastEnd = busyEnd;
+    return starts;
+}
+
+const int ENGINE_VERSION = 1;
+
+// Upper bound on the timeline length: no engine runs past the last arrival plus all the work and I/O, and the
+// lastInstant-driven engines stop exactly at lastInstant
+int timelineBound(const workload& w, int lastInstant) {
+    long long end = 0;
+    long long work = 0;
+    for (int id = 0; id < w.size(); ++id) {
+        end = std::max<long long>(end, w.arrival[id]);
+        work += w.service[id];
+    }
+    for (int id = 0; id < (int)w.burst_start.size() - 1; ++id) {
+        for (int b = w.burst_start[id] + 1; b < w.burst_start[id + 1]; b += 2) {
+            work += w.bursts[b];
+        }
+    }
+    return static_cast<int>(std::min<long long>(INT_MAX - 1, std::max<long long>(lastInstant, end + work))) + 1;
+}
+
+// Bytes the arena needs for one run over n processes and about `ticks` ticks: the timeline, per-process state
+// arrays and queue storage. Queues only ever hold one entry per dispatch, so they are bounded by the timeline as well.
+size_t arenaBytes(size_t n, size_t ticks) {
+    size_t dequeOverhead = 1024; // map + first chunk of every std::deque
+    return ticks * 3 * sizeof(int)
+         + n * (dequeOverhead + 4 * sizeof(int) + sizeof(void*))
+         + (1 << 16);
+}
+
+size_t arenaBytes(const algorithm& algo, const workload& w, size_t ticks) {
+    size_t bytes = arenaBytes(w.size(), ticks);
+    if (algo.algorithm_id == 14) {
+        // Its child set and the parked node it has in its parent's, two virtual runtimes and the set's header
+        size_t perGroup = 2 * sizeof(std::set<std::pair<long long, int>>) + 2 * sizeof(long long) + 64;
+        bytes += w.group_parent.size() * perGroup;
+    }
+    for (const algorithm& policy : algo.classes) {
+        bytes += arenaBytes(policy, w, 0);
+    }
+    return bytes;
+}
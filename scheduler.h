@@ -0,0 +1,1314 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <vector>
+#include <string>
+#include <deque>
+#include <queue>
+#include <set>
+#include <unordered_map>
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include "arena.h"
+#include "select_kernels.h"
+#include "slice_generator.h"
+#include "timing_wheel.h"
+
+//------------------------------------------------------------------------------------------------------------------------//
+//Scheduling core
+// The engines and the workload they read, with no parsing or printing. The CLI and the C API in sched_api.h are both
+// thin layers over this header.
+
+const int NO_DEADLINE = INT_MAX;
+
+struct process {
+    std::string name;
+    int arrival_time;
+    int service_time;         // Total CPU time
+    std::vector<int> bursts;  // CPU and I/O times alternating, starting and ending with CPU; empty without I/O
+    int tickets = 1;          // Lottery share
+    int deadline = NO_DEADLINE; // Time by which the process should have finished
+    int class_id = 0;         // Multi-level queue class, 0 being the most urgent
+    std::string group;        // Fair-share group path such as "tenantA:3/web", each part with an optional weight
+};
+
+struct algorithm {
+    int algorithm_id;
+    int quantum=-1;
+    unsigned long seed = 1; // Random draws of the lottery scheduler
+    std::vector<algorithm> classes;  // Multi-level queue: the policy of each class, most urgent first
+    std::vector<int> class_weights;  // Ticks per turn of each class when classes share the CPU; empty for strict priority
+};
+
+// Read-only view of the parsed input, built once and shared by every engine.
+// Processes are identified by their index in the input; all orderings are stable so ties keep input order.
+// names is empty when the caller has none, as with the C API.
+struct workload {
+    std::vector<std::string> names;
+    std::vector<int> arrival;
+    std::vector<int> service;
+    std::vector<int> by_arrival;     // process ids sorted by arrival time
+    std::vector<int> sorted_arrival; // arrival times laid out in by_arrival order
+    std::vector<int> sorted_service; // service times laid out in by_arrival order
+    std::vector<int> burst_start;    // process id -> its range in bursts, n + 1 entries
+    std::vector<int> bursts;         // CPU/I/O burst lists of the processes that have I/O
+    std::vector<int> tickets;        // Lottery share of each process
+    std::vector<int> deadlines;      // Absolute deadline of each process, NO_DEADLINE when it has none
+    std::vector<int> class_ids;      // Multi-level queue class of each process
+    std::vector<int> group_ids;      // Fair-share group of each process
+    std::vector<int> group_parent;   // group -> enclosing group; group 0 is the root, with parent -1
+    std::vector<int> group_weight;   // group -> its weight among its sibling groups and processes
+    std::unordered_map<std::string, int> group_index; // group path without weights -> group
+
+    int size() const { return arrival.size(); }
+    bool has_io() const { return !bursts.empty(); }
+    bool has_deadlines() const {
+        return std::any_of(deadlines.begin(), deadlines.end(), [](int d) { return d != NO_DEADLINE; });
+    }
+};
+
+// Per-process results of one run, indexed by process id
+struct process_stats {
+    int finish_time = 0;
+    int turnaround_time = 0;
+    float norm_turnaround_time = 0.0;
+};
+
+// Containers whose storage comes from the per-run arena
+template <class T>
+using arena_vector = std::vector<T, arena_allocator<T>>;
+template <class T>
+using arena_deque = std::deque<T, arena_allocator<T>>;
+template <class T>
+using arena_queue = std::queue<T, arena_deque<T>>;
+
+// One process id per tick, idle ticks hold IDLE
+using timeline = arena_vector<int>;
+const int IDLE = -1;
+// slice.process for whole round-robin rounds given to a sink that keeps only finish times: the CPU is busy throughout,
+// but no process finishes inside it
+const int SKIPPED = -3;
+
+// total_time for open-ended runs: engines that normally idle until lastInstant stop once every arrival is done
+const int UNTIL_DRAINED = INT_MAX;
+
+// Adds a process as the next one in arrival order and returns its id
+int appendProcess(workload& w, const process& proc);
+// Returns the group for a path like "tenantA:3/web", creating it and its ancestors as needed. A weight given in the
+// path replaces the group's earlier one; groups created without one weigh 1.
+int internGroup(workload& w, const std::string& path);
+// Builds the workload for a complete process list, in input order
+workload buildWorkload(const std::vector<process>& processes);
+// Rebuilds w from bare arrival/service arrays, reusing its storage; names are left empty
+void buildWorkload(workload& w, const int* arrival, const int* service, int n);
+// Fills in turnaround and normalized turnaround once every finish time is known
+void completeStats(const workload& w, std::vector<process_stats>& stats);
+void calculateStatsFromOutput(const workload& w, const timeline& output, std::vector<process_stats>& stats);
+// Share of the CPU each finished process was entitled to by its tickets while it was in the system
+std::vector<double> targetShares(const workload& w, const std::vector<process_stats>& stats);
+// Deadline misses and lateness (finish minus deadline) over the finished processes that have a deadline
+struct deadline_report {
+    int with_deadline = 0;
+    int missed = 0;
+    int p50 = 0, p90 = 0, p99 = 0, max = 0; // Lateness percentiles
+    double utilization = 0.0; // Busy fraction of the time from the first arrival to the last finish
+};
+deadline_report deadlineReport(const workload& w, const std::vector<process_stats>& stats);
+// Positions in by_arrival where the CPU has been idle since everything before was done, starting with 0, and the
+// time the last busy period ends. Work-conserving engines start each of these busy periods with no state left over.
+std::vector<int> idleBoundaries(const workload& w, long long& lastEnd);
+// Version of the engines' behaviour, bumped whenever a change can alter a schedule; part of every result cache key
+extern const int ENGINE_VERSION;
+// Upper bound on the timeline length
+int timelineBound(const workload& w, int lastInstant);
+// Bytes the arena needs for one run over n processes and about `ticks` ticks
+size_t arenaBytes(size_t n, size_t ticks);
+// The same for one algorithm over w, adding the group tables of HFS and the per-class engines of MLQ, which each keep
+// state for every process
+size_t arenaBytes(const algorithm& algo, const workload& w, size_t ticks);
+
+//------------------------------------------------------------------------------------------------------------------------//
+//Arrival sources
+// Engines admit processes through one of these, always in arrival order. pop_arrived hands out the next process
+// only if it has arrived by `now`; pop hands it out regardless; exhausted is true once every process has been
+// handed out. Nothing still to be handed out arrives before next_arrival, which is exact for complete inputs and a
+// lower bound for live feeds. capacity bounds the process ids so engines can size their state arrays up front.
+
+// Arrivals from a fully built workload
+struct workload_arrivals {
+    const workload& w;
+    int next = 0;
+
+    explicit workload_arrivals(const workload& w) : w(w) {}
+
+    int capacity() const { return w.size(); }
+    bool exhausted() const { return next >= w.size(); }
+    int next_arrival() const { return next < w.size() ? w.sorted_arrival[next] : INT_MAX; }
+
+    bool pop_arrived(int now, int& id) {
+        if (next >= w.size() || w.sorted_arrival[next] > now) return false;
+        id = w.by_arrival[next++];
+        return true;
+    }
+
+    bool pop(int& id) {
+        if (next >= w.size()) return false;
+        id = w.by_arrival[next++];
+        return true;
+    }
+};
+
+//------------------------------------------------------------------------------------------------------------------------//
+//Timeline outputs
+// Sinks take the schedule as emit(process, ticks) calls in time order; apply_algorithm feeds them an engine's slices.
+
+// Expands the schedule into one entry per tick
+struct timeline_output {
+    timeline& ticks;
+
+    void emit(int id, int count) {
+        ticks.insert(ticks.end(), count, id);
+    }
+};
+
+// Keeps only each process's finish time, the end of its last slice. Stats runs use this so their cost follows the
+// number of slices rather than the number of ticks
+struct finish_output {
+    static constexpr bool finishes_only = true;
+    std::vector<process_stats>& stats;
+    int now = 0;
+
+    void emit(int id, int count) {
+        if (count <= 0) return;
+        now += count;
+        if (id >= 0) stats[id].finish_time = now;
+    }
+};
+
+// Sinks that keep nothing but finish times declare finishes_only, and engines may then hand them SKIPPED slices
+template <class Output>
+constexpr bool finishesOnly() {
+    if constexpr (requires { Output::finishes_only; }) {
+        return Output::finishes_only;
+    } else {
+        return false;
+    }
+}
+
+//Algorithms
+//------------------------------------------------------------------------------------------------------------------------//
+//First Come First Serve
+template <class Arrivals>
+slice_generator fcfs(const workload& w, Arrivals& arrivals) {
+    int currentTime = 0;
+    int id;
+    while (arrivals.pop(id)) {
+        if (currentTime < w.arrival[id]) {
+            // Add idle time if the CPU is idle
+            co_yield slice{IDLE, currentTime, w.arrival[id] - currentTime};
+            currentTime = w.arrival[id];
+        }
+        co_yield slice{id, currentTime, w.service[id]};
+        currentTime += w.service[id];
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------//
+//Round Robin
+template <class Arrivals>
+slice_generator RR(const workload& w, Arrivals& arrivals, arena& mem, int quantum, bool finishesOnly) {
+    arena_allocator<int> alloc(mem);
+    arena_vector<int> remaining(arrivals.capacity(), 0, alloc);
+    arena_deque<int> ready_queue(alloc);
+    int currentTime = 0;
+    int id;
+    int untilRoundEnd = 0; // Dispatches left before the queue has turned over once
+
+    auto admitArrivals = [&]() {
+        while (arrivals.pop_arrived(currentTime, id)) {
+            remaining[id] = w.service[id];
+            ready_queue.push_back(id);
+        }
+    };
+
+    while (true) {
+        admitArrivals();
+
+        if (ready_queue.empty()) {
+            if (arrivals.exhausted())
+                break;
+            // CPU is idle until the next arrival
+            int gap = std::max(1, arrivals.next_arrival() - currentTime);
+            co_yield slice{IDLE, currentTime, gap};
+            currentTime += gap;
+            continue;
+        }
+
+        // Once per turn of the queue, skip ahead by k whole rounds if no arrival lands inside them and every ready
+        // process outlives them. Each round then gives every process one full quantum in queue order, so the queue
+        // comes out unchanged and only the remaining times move. Nothing finishes inside the rounds, so a sink that
+        // keeps only finish times gets them as one SKIPPED slice; others get one slice per quantum.
+        if (--untilRoundEnd <= 0) {
+            untilRoundEnd = ready_queue.size();
+            long long roundLength = (long long)quantum * ready_queue.size();
+            int minRemaining = INT_MAX;
+            for (int queued : ready_queue) {
+                minRemaining = std::min(minRemaining, remaining[queued]);
+            }
+            long long rounds = std::min<long long>((minRemaining - 1) / quantum,
+                                                   ((long long)arrivals.next_arrival() - currentTime - 1) / roundLength);
+            if (rounds > 0) {
+                if (ready_queue.size() == 1) {
+                    co_yield slice{ready_queue.front(), currentTime, (int)(rounds * quantum)};
+                    currentTime += rounds * quantum;
+                } else if (finishesOnly) {
+                    co_yield slice{SKIPPED, currentTime, (int)(rounds * roundLength)};
+                    currentTime += rounds * roundLength;
+                } else {
+                    for (long long r = 0; r < rounds; ++r) {
+                        for (int queued : ready_queue) {
+                            co_yield slice{queued, currentTime, quantum};
+                            currentTime += quantum;
+                        }
+                    }
+                }
+                for (int queued : ready_queue) {
+                    remaining[queued] -= rounds * quantum;
+                }
+                continue;
+            }
+        }
+
+        int processIndex = ready_queue.front();
+        ready_queue.pop_front();
+
+        int timeSlice = std::min(quantum, remaining[processIndex]);
+        co_yield slice{processIndex, currentTime, timeSlice};
+
+        currentTime += timeSlice;
+        remaining[processIndex] -= timeSlice;
+
+        admitArrivals();
+
+        if (remaining[processIndex] != 0) {
+            ready_queue.push_back(processIndex);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------//
+//Highest Response Ratio Next
+template <class Arrivals>
+slice_generator HRRN(const workload& w, Arrivals& arrivals, arena& mem) {
+    arena_vector<int> completed(arrivals.capacity(), 0, arena_allocator<int>(mem)); // Completed flags, in arrival order
+    int current_time = 0;
+    int ready_end = 0;  // Processes before this position have arrived
+    int first_live = 0; // Processes before this position have all completed
+    int id;
+
+    while (true) {
+        while (arrivals.pop_arrived(current_time, id)) {
+            ready_end++;
+        }
+        while (first_live < ready_end && completed[first_live]) {
+            first_live++;
+        }
+
+        // If no process is ready, the CPU idles until the next arrival
+        if (first_live == ready_end) {
+            if (arrivals.exhausted())
+                break;
+            int gap = std::max(1, arrivals.next_arrival() - current_time);
+            co_yield slice{IDLE, current_time, gap};
+            current_time += gap;
+            continue;
+        }
+
+        // Find the process with the highest response ratio, earliest arrival wins ties
+        int selected = first_live + hrrn_select(w.sorted_arrival.data() + first_live, w.sorted_service.data() + first_live,
+                                                completed.data() + first_live, ready_end - first_live, current_time);
+
+        // Execute the selected process
+        int selected_process = w.by_arrival[selected];
+        co_yield slice{selected_process, current_time, w.service[selected_process]};
+        current_time += w.service[selected_process];
+
+        // Mark the process as completed
+        completed[selected] = 1;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------//
+//Aging
+
+template <class Arrivals>
+slice_generator aging(const workload& w, Arrivals& arrivals, arena& mem, int total_time, int quantum) {
+    int n = arrivals.capacity();
+    int current_time = 0;
+    int id;
+    arena_allocator<int> alloc(mem);
+    arena_vector<int> current_priority(n, 0, alloc);
+    arena_vector<int> insert_time(n, 0, alloc);
+    arena_vector<int> ready_queue(alloc);
+    ready_queue.reserve(n);
+
+    // Newly arrived processes start at their initial priority, which the input gives in the service column
+    auto admitArrivals = [&]() {
+        while (arrivals.pop_arrived(current_time, id)) {
+            current_priority[id] = w.service[id];
+            insert_time[id] = current_time;
+            ready_queue.push_back(id);
+        }
+    };
+
+    while (current_time < total_time) {
+        // Add newly arrived processes to ready queue
+        admitArrivals();
+
+        if (ready_queue.empty()) {
+            if (total_time == UNTIL_DRAINED && arrivals.exhausted())
+                break;
+            co_yield slice{IDLE, current_time, 1};
+            current_time++;
+            continue;
+        }
+
+        // Find highest priority process with special handling for equal priorities
+        int current_process = -1;
+        auto highest_priority_it = ready_queue.begin();
+        for (auto it = ready_queue.begin(); it != ready_queue.end(); ++it) {
+            if (current_process == -1 ||
+                current_priority[*it] > current_priority[current_process] ||
+                (current_priority[*it] == current_priority[current_process] &&
+                 insert_time[*it] < insert_time[current_process])) {
+                current_process = *it;
+                highest_priority_it = it;
+            }
+        }
+
+        ready_queue.erase(highest_priority_it);
+
+        // Execute process
+        bool completed_quantum = false;
+        int executed_time = 0;
+        while (executed_time < quantum && current_time < total_time) {
+            co_yield slice{current_process, current_time, 1};
+            current_time++;
+            executed_time++;
+
+            // Check for new arrivals
+            admitArrivals();
+
+            // Age waiting processes
+            for (int waiting : ready_queue) {
+                current_priority[waiting]++;
+            }
+
+            completed_quantum = (executed_time == quantum);
+        }
+
+        if (current_time < total_time) {
+            if (completed_quantum || !ready_queue.empty()) {
+                current_priority[current_process] = w.service[current_process];
+            }
+            ready_queue.push_back(current_process);
+            insert_time[current_process] = current_time;
+        }
+    }
+}
+//------------------------------------------------------------------------------------------------------------------------//
+//Shortest Process Next
+template <class Arrivals>
+slice_generator SPN(const workload& w, Arrivals& arrivals, arena& mem) {
+    int current_time = 0;
+    int id;
+    arena_vector<int> heap_storage{arena_allocator<int>(mem)};
+    heap_storage.reserve(arrivals.capacity());
+
+    // Min-heap on service time, ties go to the earlier process in the input
+    auto runsLater = [&w](int a, int b) {
+        return w.service[a] > w.service[b] || (w.service[a] == w.service[b] && a > b);
+    };
+    std::priority_queue<int, arena_vector<int>, decltype(runsLater)> ready_queue(runsLater, std::move(heap_storage));
+
+    while (true) {
+        // Add processes to the ready queue if they have arrived
+        while (arrivals.pop_arrived(current_time, id)) {
+            ready_queue.push(id);
+        }
+
+        // If the ready queue is empty, CPU is idle until the next arrival
+        if (ready_queue.empty()) {
+            if (arrivals.exhausted())
+                break;
+            int gap = std::max(1, arrivals.next_arrival() - current_time);
+            co_yield slice{IDLE, current_time, gap};
+            current_time += gap;
+            continue;
+        }
+
+        // Process the shortest job
+        int current_process = ready_queue.top();
+        ready_queue.pop();
+
+        // Execute the process
+        co_yield slice{current_process, current_time, w.service[current_process]};
+        current_time += w.service[current_process];
+    }
+}
+//------------------------------------------------------------------------------------------------------------------------//
+
+//Shortest Remaining Time
+template <class Arrivals>
+slice_generator SRT(const workload& w, Arrivals& arrivals, arena& mem, int total_time) {
+    arena_vector<int> remaining(arrivals.capacity(), 0, arena_allocator<int>(mem));
+    int admitted = 0; // One past the highest admitted process id
+    int id;
+
+    for (int current_time = 0; current_time < total_time; ++current_time) {
+        while (arrivals.pop_arrived(current_time, id)) {
+            remaining[id] = w.service[id];
+            admitted = std::max(admitted, id + 1);
+        }
+
+        // First ready process with the least remaining time
+        int selected = srt_select(remaining.data(), w.arrival.data(), admitted, current_time);
+
+        if (selected == -1) {
+            if (total_time == UNTIL_DRAINED && arrivals.exhausted())
+                break;
+            co_yield slice{IDLE, current_time, 1}; // Idle time
+            continue;
+        }
+
+        remaining[selected] -= 1;
+        co_yield slice{selected, current_time, 1};
+    }
+}
+//------------------------------------------------------------------------------------------------------------------------//
+//Feedback
+// Shared by FB-1 and FB-2i: level i runs for quantum_of(i) ticks, then the process drops one level unless it is
+// the only active process at the top level
+template <class Arrivals, class Quantum>
+slice_generator feedback(const workload& w, Arrivals& arrivals, arena& mem, int total_time, Quantum quantum_of) {
+    int numberofactiveprocesses = 0;
+    int n = arrivals.capacity(); // Total number of processes, also the most queues there can be
+    arena_allocator<int> alloc(mem);
+    arena_vector<int> remaining(n, 0, alloc);
+    // Feedback queues, a level is only created once a process drops into it
+    arena_vector<arena_queue<int>> feedback_queues(alloc);
+    feedback_queues.reserve(n);
+    feedback_queues.emplace_back(alloc);
+    int current_time = 0;
+    int id;
+
+    auto admitArrivals = [&]() {
+        while (arrivals.pop_arrived(current_time, id)) {
+            remaining[id] = w.service[id];
+            feedback_queues[0].push(id);
+            numberofactiveprocesses++;
+        }
+    };
+
+    while (current_time < total_time) {
+        // Add newly arrived processes to the first feedback queue
+        admitArrivals();
+
+        bool process_executed = false;
+
+        // Iterate over feedback queues
+        for (int i = 0; i < (int)feedback_queues.size(); i++) {
+            if (!feedback_queues[i].empty()) {
+                int current_process = feedback_queues[i].front();
+                feedback_queues[i].pop();
+
+                // Execute the process for the time quantum or until it finishes
+                int time_slice = std::min(quantum_of(i), remaining[current_process]);
+
+                for (int t = 0; t < time_slice; t++) {
+                    co_yield slice{current_process, current_time, 1};
+                    remaining[current_process]--;
+                    current_time++;
+                    admitArrivals();
+                }
+
+                process_executed = true;
+
+                // Check if the process is finished
+                if (remaining[current_process] == 0) {
+                    numberofactiveprocesses--;
+                } else {
+                    if (i==0 && numberofactiveprocesses==1) {
+                        feedback_queues[i].push(current_process);
+                    } else if (i + 1 < n) {
+                        if (i + 1 == (int)feedback_queues.size()) feedback_queues.emplace_back(alloc);
+                        feedback_queues[i + 1].push(current_process);
+                    } else {
+                        feedback_queues[i].push(current_process);
+                    }
+                }
+
+                break;
+            }
+        }
+
+        if (!process_executed) {
+            if (total_time == UNTIL_DRAINED && arrivals.exhausted())
+                break;
+            co_yield slice{IDLE, current_time, 1};
+            current_time++;
+        }
+    }
+}
+
+//Feedback-1
+template <class Arrivals>
+slice_generator FB_1(const workload& w, Arrivals& arrivals, arena& mem, int total_time) {
+    return feedback(w, arrivals, mem, total_time, [](int) { return 1; });
+}
+
+//Feedback-2i
+template <class Arrivals>
+slice_generator FB_2i(const workload& w, Arrivals& arrivals, arena& mem, int total_time) {
+    // Time quantum doubles at each lower-priority level
+    return feedback(w, arrivals, mem, total_time, [](int level) { return 1 << std::min(level, 30); });
+}
+
+//------------------------------------------------------------------------------------------------------------------------//
+//Lottery
+// Each quantum goes to the holder of a ticket drawn uniformly from the ready processes' tickets. The tickets sit in a
+// Fenwick tree indexed by process id, so admitting, retiring and drawing are all O(log n). Draws come from a seeded
+// xorshift generator, so a given seed always produces the same schedule.
+
+// Prefix sums over per-process weights: O(log n) updates, and O(log n) search for the holder of the k-th unit
+struct fenwick_tree {
+    arena_vector<long long> tree; // 1-based
+    int top = 1;                  // Highest power of two not above the size
+    long long total = 0;
+
+    fenwick_tree(int n, arena& mem) : tree(n + 1, 0, arena_allocator<long long>(mem)) {
+        while (top * 2 <= n) top *= 2;
+    }
+
+    void add(int id, long long delta) {
+        total += delta;
+        for (int i = id + 1; i < (int)tree.size(); i += i & -i) {
+            tree[i] += delta;
+        }
+    }
+
+    // Smallest id whose prefix sum exceeds unit; needs 0 <= unit < total
+    int find(long long unit) const {
+        int pos = 0;
+        for (int step = top; step > 0; step >>= 1) {
+            if (pos + step < (int)tree.size() && tree[pos + step] <= unit) {
+                pos += step;
+                unit -= tree[pos];
+            }
+        }
+        return pos;
+    }
+};
+
+template <class Arrivals>
+slice_generator lottery(const workload& w, Arrivals& arrivals, arena& mem, int quantum, unsigned long seed) {
+    int n = arrivals.capacity();
+    arena_vector<int> remaining(n, 0, arena_allocator<int>(mem));
+    fenwick_tree ready(n, mem);
+    std::uint64_t state = seed * 0x9E3779B97F4A7C15ull + 1;
+    if (state == 0) state = 1;
+    int current_time = 0;
+    int id;
+
+    auto admitArrivals = [&]() {
+        while (arrivals.pop_arrived(current_time, id)) {
+            remaining[id] = w.service[id];
+            if (remaining[id] > 0) ready.add(id, w.tickets[id]);
+        }
+    };
+
+    while (true) {
+        admitArrivals();
+
+        if (ready.total == 0) {
+            if (arrivals.exhausted())
+                break;
+            int gap = std::max(1, arrivals.next_arrival() - current_time);
+            co_yield slice{IDLE, current_time, gap};
+            current_time += gap;
+            continue;
+        }
+
+        // xorshift64*, scaled onto [0, total) with a multiply instead of a biased modulo
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        std::uint64_t random = state * 0x2545F4914F6CDD1Dull;
+        long long ticket = (long long)(((unsigned __int128)random * (std::uint64_t)ready.total) >> 64);
+        int winner = ready.find(ticket);
+
+        int timeSlice = std::min(quantum, remaining[winner]);
+        co_yield slice{winner, current_time, timeSlice};
+        current_time += timeSlice;
+        remaining[winner] -= timeSlice;
+        if (remaining[winner] == 0) {
+            ready.add(winner, -w.tickets[winner]);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------//
+//Stride
+// The deterministic counterpart of the lottery: every process has a stride inversely proportional to its tickets and
+// a pass value that advances by its stride for each quantum it runs. The ready process with the lowest pass runs
+// next, taken from a min-heap, so each dispatch is O(log n). A process joins at the global pass, which advances as
+// if one ticket's worth of the whole ready set ran, so it neither owes nor is owed CPU time.
+
+const long long STRIDE1 = 1 << 30; // Stride of a single ticket; passes stay below 2^61 for any int run
+
+template <class Arrivals>
+slice_generator stride(const workload& w, Arrivals& arrivals, arena& mem, int quantum) {
+    int n = arrivals.capacity();
+    arena_allocator<long long> alloc(mem);
+    arena_vector<long long> pass(n, 0, alloc);
+    arena_vector<int> remaining(n, 0, arena_allocator<int>(mem));
+    long long globalPass = 0;
+    long long globalCarry = 0; // What the last advances of globalPass lost to integer division
+    long long readyTickets = 0;
+    int current_time = 0;
+    int id;
+
+    // Min-heap on pass value, ties go to the earlier process in the input
+    arena_vector<int> heap_storage{arena_allocator<int>(mem)};
+    heap_storage.reserve(n);
+    auto runsLater = [&pass](int a, int b) {
+        return pass[a] > pass[b] || (pass[a] == pass[b] && a > b);
+    };
+    std::priority_queue<int, arena_vector<int>, decltype(runsLater)> ready(runsLater, std::move(heap_storage));
+
+    auto admitArrivals = [&]() {
+        while (arrivals.pop_arrived(current_time, id)) {
+            remaining[id] = w.service[id];
+            if (remaining[id] == 0) continue;
+            pass[id] = globalPass;
+            readyTickets += w.tickets[id];
+            ready.push(id);
+        }
+    };
+
+    while (true) {
+        admitArrivals();
+
+        if (ready.empty()) {
+            if (arrivals.exhausted())
+                break;
+            int gap = std::max(1, arrivals.next_arrival() - current_time);
+            co_yield slice{IDLE, current_time, gap};
+            current_time += gap;
+            continue;
+        }
+
+        int current_process = ready.top();
+        ready.pop();
+        int timeSlice = std::min(quantum, remaining[current_process]);
+        co_yield slice{current_process, current_time, timeSlice};
+        current_time += timeSlice;
+        remaining[current_process] -= timeSlice;
+
+        // A partial quantum advances the passes in proportion
+        globalCarry += STRIDE1 * timeSlice;
+        globalPass += globalCarry / (quantum * readyTickets);
+        globalCarry %= quantum * readyTickets;
+        pass[current_process] += STRIDE1 / w.tickets[current_process] * timeSlice / quantum;
+        if (remaining[current_process] > 0) {
+            ready.push(current_process);
+        } else {
+            readyTickets -= w.tickets[current_process];
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------//
+//Earliest Deadline First
+// Preemptive: the ready process with the earliest deadline runs until it finishes or the next arrival, which may
+// preempt it. The ready set is a min-heap on deadline, so with one dispatch per arrival or completion the whole
+// run is O(n log n) regardless of how long the jobs are. Processes without a deadline run after every process that
+// has one; ties go to the earlier process in the input.
+template <class Arrivals>
+slice_generator EDF(const workload& w, Arrivals& arrivals, arena& mem) {
+    int n = arrivals.capacity();
+    arena_vector<int> remaining(n, 0, arena_allocator<int>(mem));
+    int current_time = 0;
+    int id;
+
+    arena_vector<int> heap_storage{arena_allocator<int>(mem)};
+    heap_storage.reserve(n);
+    auto runsLater = [&w](int a, int b) {
+        return w.deadlines[a] > w.deadlines[b] || (w.deadlines[a] == w.deadlines[b] && a > b);
+    };
+    std::priority_queue<int, arena_vector<int>, decltype(runsLater)> ready(runsLater, std::move(heap_storage));
+
+    while (true) {
+        while (arrivals.pop_arrived(current_time, id)) {
+            remaining[id] = w.service[id];
+            if (remaining[id] > 0) ready.push(id);
+        }
+
+        if (ready.empty()) {
+            if (arrivals.exhausted())
+                break;
+            int gap = std::max(1, arrivals.next_arrival() - current_time);
+            co_yield slice{IDLE, current_time, gap};
+            current_time += gap;
+            continue;
+        }
+
+        // Run until done or until the next arrival gets a chance to preempt
+        int current_process = ready.top();
+        int timeSlice = remaining[current_process];
+        if (!arrivals.exhausted()) {
+            timeSlice = std::min<long long>(timeSlice, std::max(1LL, (long long)arrivals.next_arrival() - current_time));
+        }
+        co_yield slice{current_process, current_time, timeSlice};
+        current_time += timeSlice;
+        remaining[current_process] -= timeSlice;
+        if (remaining[current_process] == 0) ready.pop();
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------//
+//Completely Fair Scheduler
+// Modelled on Linux CFS. Every process accumulates virtual runtime, the CPU time it received divided by its weight
+// (its tickets), and the process with the least virtual runtime runs next. Ready processes sit in a red-black tree
+// ordered by virtual runtime whose leftmost node is the next to run; std::set keeps begin() cached, and a dispatched
+// node is extracted and reinserted rather than reallocated. Each dispatch gets the process's weighted share of the
+// target latency, but never less than the minimum granularity (an eighth of the latency, as in Linux), so a long
+// run queue stretches the period instead of shrinking slices to nothing. Arrivals join at the smallest virtual
+// runtime in the tree so they neither starve the others nor get starved.
+
+const int CFS_DEFAULT_LATENCY = 6;
+const long long CFS_UNIT = 1 << 20; // Virtual runtime of one tick at weight 1
+
+template <class Arrivals>
+slice_generator CFS(const workload& w, Arrivals& arrivals, arena& mem, int latency) {
+    int n = arrivals.capacity();
+    int granularity = std::max(1, latency / 8);
+    arena_vector<int> remaining(n, 0, arena_allocator<int>(mem));
+    long long minVruntime = 0;
+    long long totalWeight = 0;
+    int current_time = 0;
+    int id;
+
+    // (virtual runtime, process id): ties go to the earlier process in the input
+    using entry = std::pair<long long, int>;
+    std::set<entry, std::less<entry>, arena_allocator<entry>> ready{arena_allocator<entry>(mem)};
+
+    while (true) {
+        while (arrivals.pop_arrived(current_time, id)) {
+            remaining[id] = w.service[id];
+            if (remaining[id] == 0) continue;
+            ready.insert({minVruntime, id});
+            totalWeight += w.tickets[id];
+        }
+
+        if (ready.empty()) {
+            if (arrivals.exhausted())
+                break;
+            int gap = std::max(1, arrivals.next_arrival() - current_time);
+            co_yield slice{IDLE, current_time, gap};
+            current_time += gap;
+            continue;
+        }
+
+        auto node = ready.extract(ready.begin());
+        int current_process = node.value().second;
+        long long share = static_cast<long long>(latency) * w.tickets[current_process] / totalWeight;
+        int timeSlice = static_cast<int>(std::min<long long>(remaining[current_process], std::max<long long>(granularity, share)));
+        co_yield slice{current_process, current_time, timeSlice};
+        current_time += timeSlice;
+        remaining[current_process] -= timeSlice;
+
+        node.value().first += timeSlice * CFS_UNIT / w.tickets[current_process];
+        long long leftmost = ready.empty() ? node.value().first : std::min(node.value().first, ready.begin()->first);
+        minVruntime = std::max(minVruntime, leftmost);
+        if (remaining[current_process] > 0) {
+            ready.insert(std::move(node));
+        } else {
+            totalWeight -= w.tickets[current_process];
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------//
+//Multi-level queue
+// Each class runs its own engine, unchanged, on a clock of its own that only moves while the class holds the CPU:
+// a process joins its class's queue stamped with that clock, so to the engine the class looks like a CPU of its own
+// that sometimes runs slower. The engine's slices are handed out in pieces, cut wherever an arrival may change which
+// class should run, and the rest of a cut slice is resumed the next time its class gets the CPU. Classes are picked
+// from a bitmap of the ones with unfinished work: the lowest set bit under strict priority, or the next set bit
+// after the current one when the classes take turns of class_weights ticks. Either way the choice is O(1).
+
+const int MAX_CLASSES = 64;
+
+// The processes of one class as its engine sees them, with arrivals stamped on the class's clock
+struct class_arrivals {
+    workload jobs;               // One entry per process admitted to the class, in admission order
+    std::vector<int> process_of; // job -> process
+    std::vector<int> executed;   // job -> ticks run so far
+    int limit;                   // Upper bound on the jobs the class can get
+    int next = 0;                // Next job to hand to the engine
+    int clock = 0;               // Ticks the class has run, plus any idle ticks its engine asked for
+    bool closed = false;         // No more processes will join
+
+    // Storage for `expected` jobs is taken here, so admitting them does not touch the heap
+    class_arrivals(const workload& w, int limit, int expected) : limit(limit) {
+        jobs.arrival.reserve(expected);
+        jobs.service.reserve(expected);
+        jobs.by_arrival.reserve(expected);
+        jobs.sorted_arrival.reserve(expected);
+        jobs.sorted_service.reserve(expected);
+        jobs.tickets.reserve(expected);
+        jobs.deadlines.reserve(expected);
+        jobs.class_ids.reserve(expected);
+        jobs.group_ids.reserve(expected);
+        jobs.group_parent = w.group_parent;
+        jobs.group_weight = w.group_weight;
+        process_of.reserve(expected);
+        executed.reserve(expected);
+    }
+
+    int capacity() const { return limit; }
+    bool exhausted() const { return closed && next >= jobs.size(); }
+    // Whoever joins later is stamped with the clock at that point, which never runs backwards
+    int next_arrival() const { return next < jobs.size() ? jobs.sorted_arrival[next] : exhausted() ? INT_MAX : clock; }
+
+    bool pop_arrived(int now, int& id) {
+        if (next >= jobs.size() || jobs.arrival[next] > now) return false;
+        id = next++;
+        return true;
+    }
+
+    bool pop(int& id) {
+        if (next >= jobs.size()) return false;
+        id = next++;
+        return true;
+    }
+
+    void admit(const workload& w, int p) {
+        int job = jobs.size();
+        jobs.arrival.push_back(clock);
+        jobs.service.push_back(w.service[p]);
+        jobs.by_arrival.push_back(job);
+        jobs.sorted_arrival.push_back(clock);
+        jobs.sorted_service.push_back(w.service[p]);
+        jobs.tickets.push_back(w.tickets[p]);
+        jobs.deadlines.push_back(w.deadlines[p]);
+        jobs.class_ids.push_back(w.class_ids[p]);
+        jobs.group_ids.push_back(w.group_ids[p]);
+        if (jobs.group_parent.size() != w.group_parent.size()) { // Groups streamed in since the last admission
+            jobs.group_parent = w.group_parent;
+            jobs.group_weight = w.group_weight;
+        }
+        process_of.push_back(p);
+        executed.push_back(0);
+    }
+};
+
+// Class policies can be any engine that treats service times as work; no Aging, and no nesting
+inline bool validClasses(const algorithm& algo) {
+    if (algo.classes.empty() || algo.classes.size() > MAX_CLASSES) return false;
+    if (!algo.class_weights.empty() && algo.class_weights.size() != algo.classes.size()) return false;
+    for (const algorithm& policy : algo.classes) {
+        int id = policy.algorithm_id;
+        if (id < 1 || id > 14 || id == 8 || id == 13) return false;
+    }
+    for (int weight : algo.class_weights) {
+        if (weight <= 0) return false;
+    }
+    return true;
+}
+
+template <class Arrivals>
+slice_generator schedule(const algorithm& algo, const workload& w, Arrivals& arrivals, arena& mem, int total_time,
+                         bool finishesOnly = false);
+
+// Processes whose class is past the last one configured go to the last class
+template <class Arrivals>
+slice_generator MLQ(algorithm algo, const workload& w, Arrivals& arrivals, arena& mem) {
+    int levels = algo.classes.size();
+    bool weighted = !algo.class_weights.empty();
+    std::vector<class_arrivals> queues;
+    std::vector<slice_generator> engines;
+    queues.reserve(levels); // Engines keep references into the queues
+
+    // A complete workload says how many processes each class gets; otherwise any class may get all of them
+    std::vector<int> expected(levels, 0);
+    if (w.size() == arrivals.capacity()) {
+        for (int p = 0; p < w.size(); ++p) {
+            expected[std::min(std::max(w.class_ids[p], 0), levels - 1)]++;
+        }
+    } else {
+        expected.assign(levels, arrivals.capacity());
+    }
+    for (int c = 0; c < levels; ++c) {
+        queues.emplace_back(w, arrivals.capacity(), expected[c]);
+        engines.push_back(schedule(algo.classes[c], queues[c].jobs, queues[c], mem, UNTIL_DRAINED));
+    }
+    std::vector<int> unfinished(levels, 0);
+    std::vector<slice> carry(levels, slice{IDLE, 0, 0}); // What is left of the slice each engine last handed out
+    std::uint64_t pending = 0; // Bit c is set while class c has unfinished work
+    int current_time = 0;
+    int turn = 0;   // Class whose turn it is when the classes share the CPU
+    int budget = 0; // Ticks left in that turn
+    int id;
+
+    while (true) {
+        while (arrivals.pop_arrived(current_time, id)) {
+            int c = std::min(std::max(w.class_ids[id], 0), levels - 1);
+            queues[c].admit(w, id);
+            if (w.service[id] > 0) {
+                unfinished[c]++;
+                pending |= std::uint64_t(1) << c;
+            }
+        }
+        if (arrivals.exhausted()) {
+            for (class_arrivals& q : queues) q.closed = true;
+        }
+
+        if (pending == 0) {
+            if (arrivals.exhausted())
+                break;
+            int gap = std::max(1, arrivals.next_arrival() - current_time);
+            co_yield slice{IDLE, current_time, gap};
+            current_time += gap;
+            continue;
+        }
+
+        int c = __builtin_ctzll(pending);
+        if (weighted) {
+            if (budget == 0 || !(pending >> turn & 1)) {
+                std::uint64_t later = turn + 1 < MAX_CLASSES ? pending & (~std::uint64_t(0) << (turn + 1)) : 0;
+                turn = later ? __builtin_ctzll(later) : c;
+                budget = algo.class_weights[turn];
+            }
+            c = turn;
+        }
+
+        class_arrivals& q = queues[c];
+        if (carry[c].length == 0) {
+            slice s;
+            if (!engines[c].next(s)) {
+                pending &= ~(std::uint64_t(1) << c); // The engine gave up on work it was handed
+                continue;
+            }
+            if (s.process == IDLE) {
+                q.clock += s.length;
+                continue;
+            }
+            carry[c] = s;
+            if (s.length == 0) continue;
+        }
+
+        int run = carry[c].length;
+        if (!arrivals.exhausted()) {
+            run = std::min<long long>(run, std::max(1LL, (long long)arrivals.next_arrival() - current_time));
+        }
+        if (weighted) {
+            run = std::min(run, budget);
+            budget -= run;
+        }
+        int job = carry[c].process;
+        co_yield slice{q.process_of[job], current_time, run};
+        current_time += run;
+        q.clock += run;
+        carry[c].length -= run;
+        if ((q.executed[job] += run) == q.jobs.service[job] && --unfinished[c] == 0) {
+            pending &= ~(std::uint64_t(1) << c);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------//
+//Hierarchical fair share
+// Groups form a tree, and each group divides the CPU among its active children, which are subgroups and processes,
+// by weight: group_weight for subgroups, tickets for processes. Every group keeps its active children ordered by
+// virtual runtime as in CFS, and every quantum goes to the leaf reached by following leftmost children down from the
+// root. Charging the quantum moves each entity on that path along by quantum/weight and repositions it in its parent,
+// so a dispatch is O(depth * log fan-out). A group joins its parent when its first process arrives and leaves when
+// its last one finishes. A joining entity starts at its parent's smallest virtual runtime and does not catch up on
+// time it was away.
+
+template <class Arrivals>
+slice_generator fair_share(const workload& w, Arrivals& arrivals, arena& mem, int quantum) {
+    int n = arrivals.capacity();
+    using entry = std::pair<long long, int>; // (virtual runtime, child); children n and up are groups
+    using child_set = std::set<entry, std::less<entry>, arena_allocator<entry>>;
+    using node_type = typename child_set::node_type;
+    arena_vector<int> remaining(n, 0, arena_allocator<int>(mem));
+    arena_vector<long long> vruntime(n, 0, arena_allocator<long long>(mem));
+    int groups = w.group_parent.size();
+    arena_vector<child_set> children{arena_allocator<child_set>(mem)};      // group -> its active children
+    arena_vector<long long> groupVruntime{arena_allocator<long long>(mem)}; // group -> its position in its parent
+    arena_vector<long long> minVruntime{arena_allocator<long long>(mem)};   // group -> least child vruntime, never falls
+    arena_vector<node_type> parked{arena_allocator<node_type>(mem)};        // group -> its node while it is inactive
+    children.reserve(groups);
+    groupVruntime.reserve(groups);
+    minVruntime.reserve(groups);
+    parked.reserve(groups);
+    int current_time = 0;
+    int id;
+
+    auto addGroups = [&]() {
+        while (children.size() < w.group_parent.size()) {
+            children.emplace_back(arena_allocator<entry>(mem));
+            groupVruntime.push_back(0);
+            minVruntime.push_back(0);
+            parked.emplace_back();
+        }
+    };
+
+    // Puts a child into its group, making the group active up the tree if it was not. A group rejoining its parent
+    // reuses the node it left with, so set nodes are only allocated once per process and group.
+    auto join = [&](int group, int child) {
+        while (true) {
+            bool wasActive = !children[group].empty();
+            long long& vr = child < n ? vruntime[child] : groupVruntime[child - n];
+            vr = std::max(vr, minVruntime[group]);
+            if (child >= n && !parked[child - n].empty()) {
+                parked[child - n].value().first = vr;
+                children[group].insert(std::move(parked[child - n]));
+            } else {
+                children[group].insert({vr, child});
+            }
+            if (wasActive || w.group_parent[group] < 0) return;
+            child = n + group;
+            group = w.group_parent[group];
+        }
+    };
+
+    while (true) {
+        while (arrivals.pop_arrived(current_time, id)) {
+            remaining[id] = w.service[id];
+            if (remaining[id] == 0) continue;
+            addGroups();
+            vruntime[id] = 0;
+            join(w.group_ids[id], id);
+        }
+
+        if (children.empty() || children[0].empty()) {
+            if (arrivals.exhausted())
+                break;
+            int gap = std::max(1, arrivals.next_arrival() - current_time);
+            co_yield slice{IDLE, current_time, gap};
+            current_time += gap;
+            continue;
+        }
+
+        int group = 0;
+        int current_process = children[0].begin()->second;
+        while (current_process >= n) {
+            group = current_process - n;
+            current_process = children[group].begin()->second;
+        }
+        int timeSlice = std::min(quantum, remaining[current_process]);
+        co_yield slice{current_process, current_time, timeSlice};
+        current_time += timeSlice;
+        remaining[current_process] -= timeSlice;
+
+        // Charge the slice along the path back up to the root; every entity on it is the leftmost in its parent
+        int child = current_process;
+        bool leaving = remaining[current_process] == 0;
+        while (group >= 0) {
+            bool isProcess = child < n;
+            long long& vr = isProcess ? vruntime[child] : groupVruntime[child - n];
+            int weight = isProcess ? w.tickets[child] : w.group_weight[child - n];
+            auto node = children[group].extract(children[group].begin());
+            vr += timeSlice * CFS_UNIT / weight;
+            long long leftmost = children[group].empty() ? vr : std::min(vr, children[group].begin()->first);
+            minVruntime[group] = std::max(minVruntime[group], leftmost);
+            if (!leaving) {
+                node.value().first = vr;
+                children[group].insert(std::move(node));
+            } else if (!isProcess) {
+                parked[child - n] = std::move(node);
+            }
+            leaving = children[group].empty();
+            child = n + group;
+            group = w.group_parent[group];
+        }
+    }
+}
+
+// Algorithm Applying
+// Creates the engine for an algorithm without running any of it; the generator is empty for an unknown id.
+// finishesOnly lets the engine yield SKIPPED slices, for a sink that keeps only finish times.
+template <class Arrivals>
+slice_generator schedule(const algorithm& algo, const workload& w, Arrivals& arrivals, arena& mem, int total_time,
+                         bool finishesOnly) {
+    switch (algo.algorithm_id) {
+
+        case 1:
+            return fcfs(w, arrivals);
+        case 2:
+            return RR(w, arrivals, mem, algo.quantum, finishesOnly);
+        case 3:
+            return SPN(w, arrivals, mem);
+        case 4:
+            return SRT(w, arrivals, mem, total_time);
+        case 5:
+            return HRRN(w, arrivals, mem);
+        case 6:
+            return FB_1(w, arrivals, mem, total_time);
+        case 7:
+            return FB_2i(w, arrivals, mem, total_time);
+        case 8:
+            return aging(w, arrivals, mem, total_time, algo.quantum);
+        case 9:
+            return lottery(w, arrivals, mem, std::max(1, algo.quantum), algo.seed);
+        case 10:
+            return stride(w, arrivals, mem, std::max(1, algo.quantum));
+        case 11:
+            return EDF(w, arrivals, mem);
+        case 12:
+            return CFS(w, arrivals, mem, algo.quantum > 0 ? algo.quantum : CFS_DEFAULT_LATENCY);
+        case 13:
+            if (!validClasses(algo)) return slice_generator();
+            return MLQ(algo, w, arrivals, mem);
+        case 14:
+            return fair_share(w, arrivals, mem, std::max(1, algo.quantum));
+
+
+        default:
+        return slice_generator();
+    }
+}
+
+// Runs an engine to completion into an output sink. Returns false for an unknown algorithm id
+template <class Arrivals, class Output>
+bool apply_algorithm(const algorithm& algo, const workload& w, Arrivals& arrivals, Output& output, arena& mem, int total_time) {
+    slice_generator engine = schedule(algo, w, arrivals, mem, total_time, finishesOnly<Output>());
+    if (!engine.valid()) return false;
+    for (const slice& s : engine) {
+        output.emit(s.process, s.length);
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------//
+//I/O bursts
+// A process with I/O alternates CPU bursts with I/O waits. The engines schedule every CPU burst as a job of its own:
+// burst_arrivals admits jobs as their processes arrive or finish I/O, appending each to a job workload the way the
+// streamed arrivals do, and burst_output maps jobs back to their processes. When a job's last tick is emitted,
+// burst_output puts the process's next burst on the timing wheel to wake once its I/O is done.
+
+struct burst_arrivals {
+    const workload& w; // The processes
+    workload jobs;     // One entry per admitted CPU burst, in admission order
+    std::vector<int> process_of; // job -> process
+    std::vector<int> executed;   // job -> ticks run so far
+    std::vector<int> next_burst; // process -> position in its burst list of the CPU burst to admit next
+    timing_wheel wakeups;        // Processes waiting to arrive or to finish I/O
+    int total_jobs = 0;
+
+    explicit burst_arrivals(const workload& w) : w(w), next_burst(w.size(), 0), wakeups(w.size()) {
+        for (int id = 0; id < w.size(); ++id) {
+            total_jobs += hasBursts(id) ? (w.burst_start[id + 1] - w.burst_start[id] + 1) / 2 : 1;
+        }
+        jobs.arrival.reserve(total_jobs);
+        jobs.service.reserve(total_jobs);
+        jobs.by_arrival.reserve(total_jobs);
+        jobs.sorted_arrival.reserve(total_jobs);
+        jobs.sorted_service.reserve(total_jobs);
+        jobs.tickets.reserve(total_jobs);
+        jobs.deadlines.reserve(total_jobs);
+        jobs.class_ids.reserve(total_jobs);
+        jobs.group_ids.reserve(total_jobs);
+        jobs.group_parent = w.group_parent;
+        jobs.group_weight = w.group_weight;
+        process_of.reserve(total_jobs);
+        executed.reserve(total_jobs);
+        for (int id : w.by_arrival) {
+            wakeups.schedule(w.arrival[id], id);
+        }
+    }
+
+    int capacity() const { return total_jobs; }
+    bool exhausted() const { return wakeups.empty(); }
+    int next_arrival() const { return wakeups.next_bound(); }
+
+    bool pop_arrived(int now, int& id) {
+        int p, wake;
+        if (!wakeups.pop_due(now, p, wake)) return false;
+        id = admit(p, wake);
+        return true;
+    }
+
+    bool pop(int& id) {
+        int p, wake;
+        if (!wakeups.pop_next(p, wake)) return false;
+        id = admit(p, wake);
+        return true;
+    }
+
+    // A job has run its whole burst at time `now`; its process does I/O and comes back for the next one
+    void finished(int job, int now) {
+        int p = process_of[job];
+        if (!hasBursts(p) || w.burst_start[p] + next_burst[p] >= w.burst_start[p + 1]) return;
+        wakeups.schedule(now + w.bursts[w.burst_start[p] + next_burst[p] - 1], p);
+    }
+
+private:
+    bool hasBursts(int p) const { return w.burst_start[p] < w.burst_start[p + 1]; }
+
+    // Appends the process's next CPU burst as a job that arrived when the process woke
+    int admit(int p, int arrival) {
+        int service = hasBursts(p) ? w.bursts[w.burst_start[p] + next_burst[p]] : w.service[p];
+        next_burst[p] += 2;
+        int job = jobs.size();
+        jobs.arrival.push_back(arrival);
+        jobs.service.push_back(service);
+        jobs.by_arrival.push_back(job);
+        jobs.sorted_arrival.push_back(arrival);
+        jobs.sorted_service.push_back(service);
+        jobs.tickets.push_back(w.tickets[p]);
+        jobs.deadlines.push_back(w.deadlines[p]);
+        jobs.class_ids.push_back(w.class_ids[p]);
+        jobs.group_ids.push_back(w.group_ids[p]);
+        process_of.push_back(p);
+        executed.push_back(0);
+        return job;
+    }
+};
+
+// Forwards the schedule with jobs turned back into their processes, and reports finished bursts
+template <class Output>
+struct burst_output {
+    burst_arrivals& source;
+    Output& output;
+    int now = 0;
+
+    void emit(int job, int count) {
+        if (count <= 0) return;
+        output.emit(job == IDLE ? IDLE : source.process_of[job], count);
+        now += count;
+        if (job != IDLE && (source.executed[job] += count) == source.jobs.service[job]) {
+            source.finished(job, now);
+        }
+    }
+};
+
+// Runs one algorithm over a workload, as one job per CPU burst when it has I/O. Aging reads the service column as a
+// priority rather than work, so it always runs the processes as given.
+template <class Output>
+bool run_workload(const algorithm& algo, const workload& w, Output& output, arena& mem, int total_time) {
+    if (w.has_io() && algo.algorithm_id != 8) {
+        burst_arrivals arrivals(w);
+        burst_output<Output> jobs{arrivals, output};
+        return apply_algorithm(algo, arrivals.jobs, arrivals, jobs, mem, total_time);
+    }
+    workload_arrivals arrivals(w);
+    return apply_algorithm(algo, w, arrivals, output, mem, total_time);
+}
+
+#endif
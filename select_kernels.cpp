@@ -0,0 +1,202 @@
+#include "select_kernels.h"
+
+#include <climits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SELECT_KERNELS_X86 1
+#endif
+
+//------------------------------------------------------------------------------------------------------------------------//
+//Shortest Remaining Time
+
+int srt_select_scalar(const int* remaining, const int* arrival, int n, int now) {
+    int selected = -1;
+    for (int id = 0; id < n; ++id) {
+        if (remaining[id] == 0 || arrival[id] > now) continue;
+        if (selected == -1 || remaining[id] < remaining[selected]) {
+            selected = id;
+        }
+    }
+    return selected;
+}
+
+//------------------------------------------------------------------------------------------------------------------------//
+//Highest Response Ratio Next
+
+// a/b > c/d for positive denominators
+static inline bool ratio_greater(long long a, long long b, long long c, long long d) {
+    return a * d > c * b;
+}
+
+// A 0/0 candidate never wins a comparison, so when every live candidate is one the first of them runs
+static int first_live(const int* done, int n) {
+    for (int i = 0; i < n; ++i) {
+        if (!done[i]) return i;
+    }
+    return -1;
+}
+
+int hrrn_select_scalar(const int* arrival, const int* service, const int* done, int n, int now) {
+    int selected = -1;
+    long long bestWaitPlusService = 0;
+    long long bestService = 1;
+    for (int i = 0; i < n; ++i) {
+        if (done[i]) continue;
+        long long waitPlusService = now - arrival[i] + service[i];
+        if (ratio_greater(waitPlusService, service[i], bestWaitPlusService, bestService)) {
+            bestWaitPlusService = waitPlusService;
+            bestService = service[i];
+            selected = i;
+        }
+    }
+    return selected >= 0 ? selected : first_live(done, n);
+}
+
+#ifdef SELECT_KERNELS_X86
+// Eight lanes each keep their own running minimum and the first index that reached it. Ready processes are keyed by
+// remaining - 1 so that INT_MAX can stand for "not ready" without colliding with a real key.
+__attribute__((target("avx2")))
+int srt_select_avx2(const int* remaining, const int* arrival, int n, int now) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i notReady = _mm256_set1_epi32(INT_MAX);
+    const __m256i nowVec = _mm256_set1_epi32(now);
+    const __m256i step = _mm256_set1_epi32(8);
+
+    __m256i bestKey = notReady;
+    __m256i bestIndex = _mm256_set1_epi32(-1);
+    __m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i rem = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(remaining + i));
+        __m256i arr = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(arrival + i));
+        __m256i done = _mm256_cmpeq_epi32(rem, zero);
+        __m256i future = _mm256_cmpgt_epi32(arr, nowVec);
+        __m256i key = _mm256_blendv_epi8(_mm256_sub_epi32(rem, one), notReady, _mm256_or_si256(done, future));
+        __m256i better = _mm256_cmpgt_epi32(bestKey, key);
+        bestKey = _mm256_blendv_epi8(bestKey, key, better);
+        bestIndex = _mm256_blendv_epi8(bestIndex, index, better);
+        index = _mm256_add_epi32(index, step);
+    }
+
+    alignas(32) int keys[8];
+    alignas(32) int indices[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(keys), bestKey);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(indices), bestIndex);
+
+    int selectedKey = INT_MAX;
+    int selected = -1;
+    for (int lane = 0; lane < 8; ++lane) {
+        if (keys[lane] < selectedKey || (keys[lane] == selectedKey && keys[lane] != INT_MAX && indices[lane] < selected)) {
+            selectedKey = keys[lane];
+            selected = indices[lane];
+        }
+    }
+
+    // Tail indices are all past the vector part, so only a strictly smaller key can win
+    for (; i < n; ++i) {
+        if (remaining[i] == 0 || arrival[i] > now) continue;
+        if (selected == -1 || remaining[i] - 1 < selectedKey) {
+            selectedKey = remaining[i] - 1;
+            selected = i;
+        }
+    }
+    return selected;
+}
+
+// Four 64-bit lanes, each holding the best candidate seen so far as a (wait + service, service) pair. The initial
+// pair 0/1 loses to every live candidate, whose ratio is at least 1.
+__attribute__((target("avx2")))
+int hrrn_select_avx2(const int* arrival, const int* service, const int* done, int n, int now) {
+    const __m128i nowVec = _mm_set1_epi32(now);
+    const __m256i step = _mm256_set1_epi64x(4);
+
+    __m256i bestNum = _mm256_setzero_si256();
+    __m256i bestDen = _mm256_set1_epi64x(1);
+    __m256i bestIndex = _mm256_set1_epi64x(-1);
+    __m256i index = _mm256_setr_epi64x(0, 1, 2, 3);
+
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i arr = _mm_loadu_si128(reinterpret_cast<const __m128i*>(arrival + i));
+        __m128i svc = _mm_loadu_si128(reinterpret_cast<const __m128i*>(service + i));
+        __m128i dn = _mm_loadu_si128(reinterpret_cast<const __m128i*>(done + i));
+        __m256i num = _mm256_cvtepi32_epi64(_mm_add_epi32(_mm_sub_epi32(nowVec, arr), svc));
+        __m256i den = _mm256_cvtepi32_epi64(svc);
+        __m256i live = _mm256_cvtepi32_epi64(_mm_cmpeq_epi32(dn, _mm_setzero_si128()));
+
+        // num / den > bestNum / bestDen, both sides exact in 64 bits
+        __m256i lhs = _mm256_mul_epi32(num, bestDen);
+        __m256i rhs = _mm256_mul_epi32(bestNum, den);
+        __m256i better = _mm256_and_si256(_mm256_cmpgt_epi64(lhs, rhs), live);
+
+        bestNum = _mm256_blendv_epi8(bestNum, num, better);
+        bestDen = _mm256_blendv_epi8(bestDen, den, better);
+        bestIndex = _mm256_blendv_epi8(bestIndex, index, better);
+        index = _mm256_add_epi64(index, step);
+    }
+
+    alignas(32) long long nums[4];
+    alignas(32) long long dens[4];
+    alignas(32) long long indices[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(nums), bestNum);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(dens), bestDen);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(indices), bestIndex);
+
+    long long selectedNum = 0;
+    long long selectedDen = 1;
+    int selected = -1;
+    for (int lane = 0; lane < 4; ++lane) {
+        if (indices[lane] < 0) continue;
+        if (selected == -1 || ratio_greater(nums[lane], dens[lane], selectedNum, selectedDen) ||
+            (!ratio_greater(selectedNum, selectedDen, nums[lane], dens[lane]) && indices[lane] < selected)) {
+            selectedNum = nums[lane];
+            selectedDen = dens[lane];
+            selected = static_cast<int>(indices[lane]);
+        }
+    }
+
+    // Tail positions are all past the vector part, so only a strictly higher ratio can win
+    for (; i < n; ++i) {
+        if (done[i]) continue;
+        long long num = now - arrival[i] + service[i];
+        if (ratio_greater(num, service[i], selectedNum, selectedDen)) {
+            selectedNum = num;
+            selectedDen = service[i];
+            selected = i;
+        }
+    }
+    return selected >= 0 ? selected : first_live(done, n);
+}
+
+bool kernels_use_avx2() {
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    return avx2;
+}
+#else
+int srt_select_avx2(const int* remaining, const int* arrival, int n, int now) {
+    return srt_select_scalar(remaining, arrival, n, now);
+}
+
+int hrrn_select_avx2(const int* arrival, const int* service, const int* done, int n, int now) {
+    return hrrn_select_scalar(arrival, service, done, n, now);
+}
+
+bool kernels_use_avx2() {
+    return false;
+}
+#endif
+
+int srt_select(const int* remaining, const int* arrival, int n, int now) {
+    static int (*const kernel)(const int*, const int*, int, int) =
+        kernels_use_avx2() ? srt_select_avx2 : srt_select_scalar;
+    return kernel(remaining, arrival, n, now);
+}
+
+int hrrn_select(const int* arrival, const int* service, const int* done, int n, int now) {
+    static int (*const kernel)(const int*, const int*, const int*, int, int) =
+        kernels_use_avx2() ? hrrn_select_avx2 : hrrn_select_scalar;
+    return kernel(arrival, service, done, n, now);
+}
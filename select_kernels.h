@@ -0,0 +1,26 @@
+#ifndef SELECT_KERNELS_H
+#define SELECT_KERNELS_H
+
+//------------------------------------------------------------------------------------------------------------------------//
+//Selection kernels
+// Hot per-decision scans over contiguous per-process arrays. Each kernel has a scalar version and, on x86, an AVX2
+// version; the plain entry point picks one at startup from the CPU features.
+
+// Index of the ready process (remaining > 0 and arrival <= now) with the least remaining time, first index on ties,
+// or -1 when nothing is ready
+int srt_select(const int* remaining, const int* arrival, int n, int now);
+int srt_select_scalar(const int* remaining, const int* arrival, int n, int now);
+int srt_select_avx2(const int* remaining, const int* arrival, int n, int now);
+
+// Position of the live candidate (done == 0) with the highest response ratio (now - arrival + service) / service,
+// lowest position on ties, or -1 when every candidate is done. A candidate with no service that has just arrived has
+// no ratio (0/0); it is picked only when every live candidate is one, and then the first. Ratios are compared exactly
+// by cross-multiplying in 64 bits, so now + service must fit in an int.
+int hrrn_select(const int* arrival, const int* service, const int* done, int n, int now);
+int hrrn_select_scalar(const int* arrival, const int* service, const int* done, int n, int now);
+int hrrn_select_avx2(const int* arrival, const int* service, const int* done, int n, int now);
+
+// True when the AVX2 kernels are compiled in and the CPU supports them
+bool kernels_use_avx2();
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef SLICE_GENERATOR_H
+#define SLICE_GENERATOR_H
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+// A run of consecutive ticks given to one process (or IDLE)
+struct slice {
+    int process;
+    int start;
+    int length;
+};
+
+//------------------------------------------------------------------------------------------------------------------------//
+//Slice generator
+// Engines are coroutines that co_yield their schedule one slice at a time. Nothing runs until the consumer asks for
+// the next slice, so a consumer can stop at any point (destroying the generator frees the engine's state) or walk
+// several schedules in lockstep without storing any of them.
+class slice_generator {
+public:
+    struct promise_type {
+        slice current{};
+
+        slice_generator get_return_object() {
+            return slice_generator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        std::suspend_always yield_value(slice s) noexcept {
+            current = s;
+            return {};
+        }
+        void return_void() noexcept {}
+        // Engine exceptions surface from next() in the consumer
+        void unhandled_exception() { throw; }
+    };
+
+    struct sentinel {};
+
+    struct iterator {
+        slice_generator* gen;
+
+        const slice& operator*() const { return gen->handle.promise().current; }
+        iterator& operator++() {
+            gen->advance();
+            return *this;
+        }
+        bool operator==(sentinel) const { return gen->done(); }
+        bool operator!=(sentinel) const { return !gen->done(); }
+    };
+
+    // An empty generator, used for unknown algorithms
+    slice_generator() = default;
+    ~slice_generator() {
+        if (handle) handle.destroy();
+    }
+
+    slice_generator(slice_generator&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    slice_generator& operator=(slice_generator&& other) noexcept {
+        if (this != &other) {
+            if (handle) handle.destroy();
+            handle = std::exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+    slice_generator(const slice_generator&) = delete;
+    slice_generator& operator=(const slice_generator&) = delete;
+
+    bool valid() const { return static_cast<bool>(handle); }
+
+    // Runs the engine up to its next slice; false once the schedule is over
+    bool next(slice& s) {
+        advance();
+        if (done()) return false;
+        s = handle.promise().current;
+        return true;
+    }
+
+    iterator begin() {
+        advance();
+        return iterator{this};
+    }
+    sentinel end() { return {}; }
+
+private:
+    explicit slice_generator(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+    void advance() {
+        if (handle && !handle.done()) handle.resume();
+    }
+    bool done() const { return !handle || handle.done(); }
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+#endif
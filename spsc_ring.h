@@ -0,0 +1,87 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------//
+//Single-producer single-consumer ring
+// Bounded lock-free queue between exactly two threads. The producer only writes tail, the consumer only writes head,
+// and each side caches the other's index so the shared cache lines are touched only when the cached view runs out.
+// The blocking push/pop spin briefly and then yield, which keeps them usable on machines with fewer cores than stages.
+template <class T>
+class spsc_ring {
+public:
+    // capacity is rounded up to a power of two
+    explicit spsc_ring(std::size_t capacity) {
+        std::size_t size = 2;
+        while (size < capacity) size <<= 1;
+        slots.resize(size);
+        mask = size - 1;
+    }
+
+    spsc_ring(const spsc_ring&) = delete;
+    spsc_ring& operator=(const spsc_ring&) = delete;
+
+    // Moves from value only when there is room
+    bool try_push(T& value) {
+        std::size_t t = tail.load(std::memory_order_relaxed);
+        if (t - cachedHead > mask) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (t - cachedHead > mask) return false;
+        }
+        slots[t & mask] = std::move(value);
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_pop(T& value) {
+        std::size_t h = head.load(std::memory_order_relaxed);
+        if (h == cachedTail) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (h == cachedTail) return false;
+        }
+        value = std::move(slots[h & mask]);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    void push(T value) {
+        for (int spins = 0; !try_push(value); ++spins) {
+            backoff(spins);
+        }
+    }
+
+    // Blocks until a value is available; false once the producer has closed the ring and it is drained
+    bool pop(T& value) {
+        for (int spins = 0;; ++spins) {
+            if (try_pop(value)) return true;
+            if (closed.load(std::memory_order_acquire)) return try_pop(value);
+            backoff(spins);
+        }
+    }
+
+    // Producer side: no more values will be pushed
+    void close() { closed.store(true, std::memory_order_release); }
+
+private:
+    static void backoff(int spins) {
+        if (spins > 64) std::this_thread::yield();
+    }
+
+    std::vector<T> slots;
+    std::size_t mask;
+
+    alignas(64) std::atomic<std::size_t> head{0};
+    std::size_t cachedTail = 0; // consumer's view of tail
+
+    alignas(64) std::atomic<std::size_t> tail{0};
+    std::size_t cachedHead = 0; // producer's view of head
+
+    alignas(64) std::atomic<bool> closed{false};
+};
+
+#endif
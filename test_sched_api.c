@@ -0,0 +1,85 @@
+#include <stdio.h>
+#include "sched_api.h"
+
+//------------------------------------------------------------------------------------------------------------------------//
+//C API check
+// Built as C and linked against libsched.a, the way a C caller would use it. Runs the README example, then again with
+// too few slices, then every kind of invalid input, and checks the return codes and the results.
+// Usage: ./test_sched_api
+
+static int failures = 0;
+
+static void expect(int got, int expected, const char* what) {
+    if (got != expected) {
+        printf("FAIL: %s gave %d, expected %d\n", what, got, expected);
+        failures++;
+    }
+}
+
+int main(void) {
+    int arrival[] = {0, 2, 4}, service[] = {3, 6, 4};
+    int finish[3], turnaround[3];
+    float norm[3];
+    sched_slice slices[16];
+    sched_result result = {finish, turnaround, norm, slices, 16, 0};
+
+    sched_context* ctx = sched_create(0);
+    if (!ctx) {
+        printf("FAIL: sched_create returned NULL\n");
+        return 1;
+    }
+
+    // The README example: RR with quantum 4 runs A 0-3, B 3-7, C 7-11, B 11-13
+    sched_algorithm rr = {2, 4, 0};
+    const int expectedFinish[] = {3, 13, 11};
+    const sched_slice expectedSlices[] = {{0, 0, 3}, {1, 3, 4}, {2, 7, 4}, {1, 11, 2}};
+    expect(sched_run(ctx, arrival, service, 3, rr, 20, &result), SCHED_OK, "README example");
+    expect((int)result.slice_count, 4, "README example slice count");
+    for (int i = 0; i < 3; ++i) {
+        expect(finish[i], expectedFinish[i], "README example finish");
+        expect(turnaround[i], expectedFinish[i] - arrival[i], "README example turnaround");
+        expect((int)(norm[i] * service[i] + 0.5f), turnaround[i], "README example normalized turnaround");
+    }
+    for (int i = 0; i < 4 && i < (int)result.slice_count; ++i) {
+        expect(slices[i].process, expectedSlices[i].process, "README example slice process");
+        expect(slices[i].start, expectedSlices[i].start, "README example slice start");
+        expect(slices[i].length, expectedSlices[i].length, "README example slice length");
+    }
+
+    // Room for two slices: the first two are written, the count covers the whole schedule
+    sched_slice few[2];
+    sched_result truncated = {finish, NULL, NULL, few, 2, 0};
+    expect(sched_run(ctx, arrival, service, 3, rr, 20, &truncated), SCHED_SLICES_TRUNCATED, "two slices");
+    expect((int)truncated.slice_count, 4, "two slices slice count");
+    expect(few[1].process, 1, "two slices second process");
+    expect(few[1].length, 4, "two slices second length");
+    expect(finish[1], 13, "two slices finish");
+
+    // Without a slice array nothing is truncated
+    sched_result finishOnly = {finish, NULL, NULL, NULL, 0, 0};
+    expect(sched_run(ctx, arrival, service, 3, rr, 20, &finishOnly), SCHED_OK, "no slices");
+
+    // Invalid input
+    sched_result noFinish = {NULL, NULL, NULL, NULL, 0, 0};
+    sched_algorithm rrZero = {2, 0, 0}, aging = {8, 2, 0}, mlq = {13, 0, 0}, unknown = {99, 0, 0};
+    expect(sched_run(NULL, arrival, service, 3, rr, 20, &result), SCHED_INVALID_ARGUMENT, "NULL context");
+    expect(sched_run(ctx, arrival, service, 3, rr, 20, NULL), SCHED_INVALID_ARGUMENT, "NULL result");
+    expect(sched_run(ctx, arrival, service, 3, rr, 20, &noFinish), SCHED_INVALID_ARGUMENT, "NULL finish");
+    expect(sched_run(ctx, NULL, service, 3, rr, 20, &result), SCHED_INVALID_ARGUMENT, "NULL arrival");
+    expect(sched_run(ctx, arrival, service, 3, rrZero, 20, &result), SCHED_INVALID_ARGUMENT, "RR quantum 0");
+    expect(sched_run(ctx, arrival, service, 3, aging, 0, &result), SCHED_INVALID_ARGUMENT, "Aging without last_instant");
+    expect(sched_run(ctx, arrival, service, 3, mlq, 20, &result), SCHED_INVALID_ALGORITHM, "MLQ");
+    expect(sched_run(ctx, arrival, service, 3, unknown, 20, &result), SCHED_INVALID_ALGORITHM, "algorithm 99");
+
+    // The context still works after the errors
+    expect(sched_run(ctx, arrival, service, 3, rr, 20, &result), SCHED_OK, "README example again");
+    expect(finish[1], 13, "README example again finish");
+    sched_destroy(ctx);
+
+    if (failures) {
+        printf("%d failed\n", failures);
+        return 1;
+    }
+    printf("sched_api: all checks passed\n");
+    return 0;
+}
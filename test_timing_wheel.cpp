@@ -0,0 +1,111 @@
+#include <climits>
+#include <cstdio>
+#include <functional>
+#include <queue>
+#include <random>
+#include <tuple>
+#include <vector>
+#include "timing_wheel.h"
+
+//------------------------------------------------------------------------------------------------------------------------//
+//Timing wheel check
+// Drives the wheel with random timers next to a std::priority_queue ordered by (expiry, order scheduled) and checks
+// that both hand out the same timers in the same order. Expiries are drawn at distances from the clock that land in
+// every level, so timers cascade down across all of them, and negative times cover the offset keys.
+// Usage: ./test_timing_wheel [rounds] [seed]
+
+using timer = std::tuple<int, long long, int>; // (expiry, order scheduled, value)
+
+int main(int argc, char** argv) {
+    int rounds = argc > 1 ? std::atoi(argv[1]) : 200;
+    unsigned seed = argc > 2 ? std::atoi(argv[2]) : 1;
+    std::mt19937 rng(seed);
+    const int capacity = 512;
+    long long checked = 0;
+
+    for (int round = 0; round < rounds; ++round) {
+        timing_wheel wheel(capacity);
+        std::priority_queue<timer, std::vector<timer>, std::greater<>> reference;
+        long long order = 0;
+        int start = round % 2 ? -1000000 : 0;
+        int clock = start; // Latest time handed out or passed to pop_due
+
+        // A distance from the clock in one of the four levels, or a tie with it
+        auto distance = [&]() {
+            switch (rng() % 5) {
+                case 0: return 0;
+                case 1: return int(rng() % 256);
+                case 2: return int(rng() % 65536);
+                case 3: return int(rng() % (1 << 24));
+                default: return int(rng() % (1u << 30));
+            }
+        };
+        // Matches the timer a pop handed out against the reference
+        auto check = [&](bool popped, int v, int at, const char* how) {
+            if (!popped) {
+                std::printf("FAIL: round %d %s found nothing, %zu pending\n", round, how, reference.size());
+                return false;
+            }
+            auto [expiry, scheduled, value] = reference.top();
+            reference.pop();
+            if (expiry != at || value != v) {
+                std::printf("FAIL: round %d %s gave (%d, %d), expected (%d, %d)\n", round, how, at, v, expiry, value);
+                return false;
+            }
+            checked++;
+            return true;
+        };
+
+        for (int step = 0; step < 4000; ++step) {
+            int action = rng() % 4;
+            if (action <= 1 && wheel.size() < capacity) {
+                long long time = (long long)clock + distance();
+                if (time > INT_MAX) time = INT_MAX;
+                // The value is the order scheduled, so ties must come out in that order
+                int v = int(order++);
+                wheel.schedule(int(time), v);
+                reference.push({int(time), v, v});
+            } else if (action == 2) {
+                // Everything due by a time a little past the clock, which may also be past every timer
+                long long time = (long long)clock + distance() / 4;
+                if (time > INT_MAX) time = INT_MAX;
+                int v, at;
+                while (!reference.empty() && std::get<0>(reference.top()) <= time) {
+                    bool popped = wheel.pop_due(int(time), v, at);
+                    if (!check(popped, v, at, "pop_due")) return 1;
+                }
+                if (wheel.pop_due(int(time), v, at)) {
+                    std::printf("FAIL: round %d pop_due(%lld) gave (%d, %d) early\n", round, time, at, v);
+                    return 1;
+                }
+                clock = int(time);
+            } else if (!reference.empty()) {
+                int bound = wheel.next_bound();
+                if (bound > std::get<0>(reference.top())) {
+                    std::printf("FAIL: round %d next_bound %d is past the next expiry %d\n", round, bound,
+                                std::get<0>(reference.top()));
+                    return 1;
+                }
+                int v, at;
+                bool popped = wheel.pop_next(v, at);
+                if (!check(popped, v, at, "pop_next")) return 1;
+                clock = at;
+            }
+            if (wheel.size() != (int)reference.size() || wheel.empty() != reference.empty()) {
+                std::printf("FAIL: round %d holds %d timers, expected %zu\n", round, wheel.size(), reference.size());
+                return 1;
+            }
+        }
+        int v, at;
+        while (!reference.empty()) {
+            bool popped = wheel.pop_next(v, at);
+            if (!check(popped, v, at, "pop_next")) return 1;
+        }
+        if (wheel.pop_next(v, at) || wheel.next_bound() != INT_MAX) {
+            std::printf("FAIL: round %d wheel not empty at the end\n", round);
+            return 1;
+        }
+    }
+    std::printf("timing_wheel: %lld timers in order over %d rounds\n", checked, rounds);
+    return 0;
+}
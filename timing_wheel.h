@@ -0,0 +1,159 @@
+#ifndef TIMING_WHEEL_H
+#define TIMING_WHEEL_H
+
+#include <climits>
+#include <cstdint>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------//
+//Hierarchical timing wheel
+// Pending timers keyed by an int expiry time, each carrying an int value. Four levels of 256 slots cover the whole
+// int range: a timer sits in the lowest level whose current block contains its expiry, and when the clock enters a
+// slot of a higher level that slot's timers move down a level. Scheduling is O(1), and every timer moves down at
+// most three times. Occupancy bitmaps let the clock jump straight to the next non-empty slot however far away it
+// is. Timers that expire at the same time come out in the order they were scheduled.
+class timing_wheel {
+public:
+    // capacity bounds the number of timers pending at once
+    explicit timing_wheel(int capacity) : next(capacity), value(capacity), expiry(capacity) {
+        for (int i = 0; i < capacity; ++i) {
+            next[i] = i + 1 < capacity ? i + 1 : -1;
+        }
+        free_list = capacity > 0 ? 0 : -1;
+        for (auto& level : head) {
+            for (int& h : level) h = -1;
+        }
+        for (auto& level : tail) {
+            for (int& t : level) t = -1;
+        }
+    }
+
+    bool empty() const { return pending == 0; }
+    int size() const { return pending; }
+
+    // time must not be earlier than the latest time passed to pop_due or handed out by pop_next
+    void schedule(int time, int v) {
+        int node = free_list;
+        free_list = next[node];
+        value[node] = v;
+        expiry[node] = key(time);
+        place(node);
+        pending++;
+    }
+
+    // Hands out the earliest timer that has expired by `time`, with its expiry in `at`
+    bool pop_due(int time, int& v, int& at) {
+        std::uint32_t target = key(time);
+        if (target < now) return false;
+        return advance(target, v, at);
+    }
+
+    // Hands out the earliest timer, however far ahead it is
+    bool pop_next(int& v, int& at) {
+        return pending > 0 && advance(UINT32_MAX, v, at);
+    }
+
+    // No pending timer expires before this; exact when the next timer is in the lowest level
+    int next_bound() const {
+        std::uint32_t bound = UINT32_MAX;
+        for (int level = levels - 1; level >= 0; --level) {
+            int slot = nextSlot(level, level == 0 ? index(0, now) : index(level, now) + 1);
+            if (slot < 0) continue;
+            int shift = 8 * level;
+            std::uint32_t blockBase = shift + 8 >= 32 ? 0 : now & ~((std::uint32_t(1) << (shift + 8)) - 1);
+            std::uint32_t start = blockBase | (std::uint32_t(slot) << shift);
+            if (start < bound) bound = start;
+        }
+        return pending > 0 ? timeOf(bound) : INT_MAX;
+    }
+
+private:
+    static const int levels = 4;
+    static const int slots = 256;
+
+    // Times are stored offset so that INT_MIN maps to 0 and the order is kept
+    static std::uint32_t key(int time) { return std::uint32_t(time) ^ 0x80000000u; }
+    static int timeOf(std::uint32_t k) { return int(k ^ 0x80000000u); }
+    static int index(int level, std::uint32_t k) { return (k >> (8 * level)) & (slots - 1); }
+
+    // The level is set by the highest byte where the expiry differs from the clock
+    void place(int node) {
+        std::uint32_t differ = expiry[node] ^ now;
+        int level = differ == 0 ? 0 : (31 - __builtin_clz(differ)) / 8;
+        int slot = index(level, expiry[node]);
+        next[node] = -1;
+        if (head[level][slot] < 0) {
+            head[level][slot] = node;
+            occupied[level][slot / 64] |= std::uint64_t(1) << (slot % 64);
+        } else {
+            next[tail[level][slot]] = node;
+        }
+        tail[level][slot] = node;
+    }
+
+    // First occupied slot of a level at or after `from`, or -1
+    int nextSlot(int level, int from) const {
+        for (int word = from / 64; from < slots && word < slots / 64; ++word) {
+            std::uint64_t bits = occupied[level][word];
+            if (word == from / 64) bits &= ~std::uint64_t(0) << (from % 64);
+            if (bits) return word * 64 + __builtin_ctzll(bits);
+        }
+        return -1;
+    }
+
+    // Moves the clock forward until the current lowest-level slot has a timer or the target is reached
+    bool advance(std::uint32_t target, int& v, int& at) {
+        while (true) {
+            int slot = index(0, now);
+            int node = head[0][slot];
+            if (node >= 0) {
+                head[0][slot] = next[node];
+                if (next[node] < 0) occupied[0][slot / 64] &= ~(std::uint64_t(1) << (slot % 64));
+                v = value[node];
+                at = timeOf(expiry[node]);
+                next[node] = free_list;
+                free_list = node;
+                pending--;
+                return true;
+            }
+            if (pending == 0 || now == target) return false;
+
+            // Every slot before the next bound is empty, so the clock can jump there directly
+            std::uint32_t jump = key(next_bound());
+            if (jump > target) {
+                now = target;
+                return false;
+            }
+            now = jump;
+            // Entering a slot at a higher level: move its timers down, highest level first
+            for (int level = levels - 1; level >= 1; --level) {
+                if ((now & ((std::uint32_t(1) << (8 * level)) - 1)) == 0) cascade(level, index(level, now));
+            }
+        }
+    }
+
+    void cascade(int level, int slot) {
+        int node = head[level][slot];
+        head[level][slot] = -1;
+        tail[level][slot] = -1;
+        occupied[level][slot / 64] &= ~(std::uint64_t(1) << (slot % 64));
+        while (node >= 0) {
+            int following = next[node];
+            place(node);
+            node = following;
+        }
+    }
+
+    std::vector<int> next;
+    std::vector<int> value;
+    std::vector<std::uint32_t> expiry;
+    int free_list;
+    int pending = 0;
+    std::uint32_t now = 0;
+
+    int head[levels][slots];
+    int tail[levels][slots];
+    std::uint64_t occupied[levels][slots / 64] = {};
+};
+
+#endif
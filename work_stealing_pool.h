@@ -0,0 +1,140 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------//
+//Work-stealing pool
+// Every worker owns a deque. Tasks submitted from inside a task go to the submitting worker's own deque and are
+// run newest-first, which keeps a parent's children on the core that produced them; idle workers steal the
+// oldest task from someone else's deque, which tends to be the biggest piece of remaining work. Tasks receive the
+// index of the worker running them so they can use per-worker scratch state.
+class work_stealing_pool {
+public:
+    using task = std::function<void(int worker)>;
+
+    explicit work_stealing_pool(int workers) {
+        for (int i = 0; i < workers; ++i) {
+            queues.emplace_back(new queue);
+        }
+        for (int i = 0; i < workers; ++i) {
+            threads.emplace_back([this, i]() { run(i); });
+        }
+    }
+
+    ~work_stealing_pool() {
+        {
+            std::lock_guard<std::mutex> guard(idleLock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    work_stealing_pool(const work_stealing_pool&) = delete;
+    work_stealing_pool& operator=(const work_stealing_pool&) = delete;
+
+    int size() const { return threads.size(); }
+    long steals() const { return stolen.load(); }
+
+    void submit(task t) {
+        int target = currentWorker() >= 0 ? currentWorker() : nextQueue++ % queues.size();
+        unfinished++;
+        {
+            std::lock_guard<std::mutex> guard(queues[target]->lock);
+            queues[target]->tasks.push_back(std::move(t));
+        }
+        {
+            std::lock_guard<std::mutex> guard(idleLock);
+            queued++;
+        }
+        wake.notify_one();
+    }
+
+    // Blocks until every submitted task, including the ones tasks submitted, has finished
+    void wait() {
+        std::unique_lock<std::mutex> guard(idleLock);
+        finished.wait(guard, [this]() { return unfinished.load() == 0; });
+    }
+
+private:
+    struct alignas(64) queue {
+        std::mutex lock;
+        std::deque<task> tasks;
+    };
+
+    static int& currentWorker() {
+        static thread_local int worker = -1;
+        return worker;
+    }
+
+    bool popLocal(int self, task& t) {
+        std::lock_guard<std::mutex> guard(queues[self]->lock);
+        if (queues[self]->tasks.empty()) return false;
+        t = std::move(queues[self]->tasks.back());
+        queues[self]->tasks.pop_back();
+        return true;
+    }
+
+    bool steal(int self, task& t) {
+        int n = queues.size();
+        for (int k = 1; k < n; ++k) {
+            queue& victim = *queues[(self + k) % n];
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if (victim.tasks.empty()) continue;
+            t = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            stolen++;
+            return true;
+        }
+        return false;
+    }
+
+    void run(int self) {
+        currentWorker() = self;
+        task t;
+        while (true) {
+            if (popLocal(self, t) || steal(self, t)) {
+                {
+                    std::lock_guard<std::mutex> guard(idleLock);
+                    queued--;
+                }
+                t(self);
+                t = nullptr;
+                if (--unfinished == 0) {
+                    std::lock_guard<std::mutex> guard(idleLock);
+                    finished.notify_all();
+                }
+                continue;
+            }
+
+            // Nothing anywhere: sleep until a task is queued
+            std::unique_lock<std::mutex> guard(idleLock);
+            wake.wait(guard, [this]() { return stopping || queued > 0; });
+            if (stopping) return;
+        }
+    }
+
+    std::vector<std::unique_ptr<queue>> queues;
+    std::vector<std::thread> threads;
+    std::atomic<long> unfinished{0};
+    std::atomic<long> stolen{0};
+    std::atomic<unsigned> nextQueue{0};
+
+    std::mutex idleLock;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    long queued = 0; // tasks sitting in some deque, guarded by idleLock
+    bool stopping = false;
+};
+
+#endif